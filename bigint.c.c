@@ -1,44 +1,251 @@
-/* 
-Since implementation has to be done for a 1024-bit integer we can calculate the number of bits required to
-represent it as an integer and create a array of char type of that size
---> n bit integer can represent upto (2^n-1) -1
---> we have a 1024-bit integer which can at max represent an integer of value equivalent to 2^1023 - 1
---> if we take a n digit integer(reprented in the digits 0- 9) it can at max represent (10^n-1) - 1
---> now equalling them and using logarithm we get n <= 309
---> thus we can conlude that a 1024 bit binary integer can be easily represented in a 309 bit integer representation
+/*
+Since implementation has to be done for a 1024-bit integer we store the number in binary limbs
+--> a limb is a 32 bit unsigned integer, so the number is written in base 2^32
+--> 1024 bits / 32 bits per limb = 32 limbs, so a full 1024-bit integer needs only 32 limbs
+--> limbs are stored little endian, limb_array[0] holds the least significant 32 bits
+--> a 64 bit unsigned integer (dlimb_t) is wide enough to hold limb * limb + limb + limb, so carries never get lost
+--> decimal is used only at the edges: readNumFromString converts decimal text into limbs and printDigits converts back
+--> a 1024 bit integer can represent upto (2^1023) - 1, which is 309 decimal digits, so input is still limited to 309 digits
+--> the width is a compile time parameter (BIGINT_BITS), MAX_LIMBS and MAX_DIGITS follow from it
 */
 
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
-#include<stdint.h> //for unsigned integers of 8bits(1byte)
+#include<stdint.h> //for fixed width unsigned integers used as limbs
+#include<time.h> //for the benchmark timer
+#include<pthread.h> //for the batch worker pool and the lock around the powers of ten table
+#include<limits.h> //for SHRT_MAX, a threshold no operand reaches switches a multiplication tier off
+#include<fcntl.h> //open, and with the three below, the memory mapped binary files
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
 
-#define BIGINT_SIZE 311 //309 digits + 1 for sign + 1 for \0(null termiantor)
-#define MAX_DIGITS 309 //maximum digits is 309 digits as explained above
-//as we are using 8 bit unsigned integers to store digits
-#define BASE 10
-#define KARATSUBA_THRESHOLD 32 // threshold for Karatsuba multiplication, can be adjusted based on performance needs
+#ifdef BIGINT_TUNED
+#include "bigint_tuned.h" //written by ./bigint --tune, defines the multiplication thresholds measured on this machine
+#endif
+
+#ifndef BIGINT_BITS
+#define BIGINT_BITS 1024 //width of the library, -DBIGINT_BITS=2048 (or any multiple of 32) builds a wider one
+#endif
+#if BIGINT_BITS % 32 != 0
+#error BIGINT_BITS must be a multiple of 32
+#endif
+#define MAX_DIGITS (BIGINT_BITS * 30103 / 100000 + 1) //digits of 2^BIGINT_BITS (log10(2) = 0.30103), 309 for 1024 bits
+#define BIGINT_SIZE (MAX_DIGITS + 2) //digits + 1 for sign + 1 for \0(null termiantor)
+#define LIMB_BITS 32 //bits stored in one limb
+#define MAX_LIMBS (BIGINT_BITS / LIMB_BITS) //32 limbs for 1024 bits
+#define BIGINT_STRINGIFY(x) #x
+#define BIGINT_TEXT(x) BIGINT_STRINGIFY(x) //expands x first, BIGINT_TEXT(BIGINT_BITS) is "1024"
+#define BASE ((dlimb_t)1 << LIMB_BITS) //every limb is one digit in base 2^32
+#define DEC_CHUNK 1000000000u //10^9 is the largest power of ten that fits in one limb
+#define DEC_CHUNK_DIGITS 9 //number of decimal digits in one DEC_CHUNK
+#ifndef KARATSUBA_THRESHOLD
+#define KARATSUBA_THRESHOLD 32 // default threshold (in limbs) for Karatsuba multiplication, ./bigint --tune measures the real one
+#endif
+#define KARATSUBA_MIN_THRESHOLD 4 // below this the two halves plus their carry limb are not smaller than the operand
+
+typedef uint32_t limb_t; //one digit in base 2^32
+typedef uint64_t dlimb_t; //double width limb, holds the product of two limbs plus carries
 
 typedef enum {FALSE, TRUE} bool;
 typedef enum {POSITIVE, NEGATIVE} numSign;
 typedef enum {SMALL = -1, EQUAL, LARGE} compareStatus;
 
 typedef struct BigInt {
-    uint8_t* digit_array;// as my numbers are from 0 - 9, so they can be stored unsigned 8bit integers (rang : 0 - 255)
+    limb_t* limb_array;// base 2^32 digits, least significant limb first
     numSign sign; //negative = 1, positive = 0
-    short size;//as size <= 311 so it can be stored in short (range : -32768 to 32767)
+    short size;//number of limbs in use
+    short capacity;//number of limbs allocated in limb_array, the _into functions reuse them while they are enough
 }BigInt;
 
+/*
+Status flags
+--> the arithmetic never prints and never exits, a call that cannot give the expected answer raises a flag on the
+    calling thread and returns: an overflow still returns the full result, a failed allocation or a division by zero
+    returns zero (a BigInt with no limbs, which freeBigInt accepts), and so does a result longer than SHRT_MAX limbs,
+    which no BigInt can hold (BIGINT_OVERFLOW)
+--> flags stay raised until clearBigIntStatus (like the floating point exception flags of fenv.h), so a caller can run a
+    whole computation and check once, printing is left to the caller (the interactive menu and the batch mode do it)
+--> the flags are per thread, so the batch workers and any other threads never share them
+*/
+typedef enum {BIGINT_OK = 0, BIGINT_OVERFLOW = 1, BIGINT_NO_MEMORY = 2, BIGINT_DIVISION_BY_ZERO = 4, BIGINT_INVALID_ARGUMENT = 8} bigIntStatus;
+
+__thread int bigIntStatusFlags = BIGINT_OK;
+
+void raiseBigIntStatus (bigIntStatus status) {
+    bigIntStatusFlags |= status;
+}
+
+//every flag raised on this thread since the last clearBigIntStatus, BIGINT_OK when none
+int getBigIntStatus () {
+    return bigIntStatusFlags;
+}
+
+void clearBigIntStatus () {
+    bigIntStatusFlags = BIGINT_OK;
+}
+
+//message for the most serious flag in status (a getBigIntStatus value), so a caller can print one line per failure
+const char* bigIntStatusMessage (int status) {
+    if (status & BIGINT_NO_MEMORY) {
+        return "memory allocation failed";
+    }
+    if (status & BIGINT_DIVISION_BY_ZERO) {
+        return "division by zero";
+    }
+    if (status & BIGINT_INVALID_ARGUMENT) {
+        return "invalid argument";
+    }
+    if (status & BIGINT_OVERFLOW) {
+        return "result exceeds " BIGINT_TEXT(BIGINT_BITS) " bits";
+    }
+    return "ok";
+}
+
+//a result of size limbs does not fit in MAX_LIMBS: the result is kept, only the flag is raised
+void checkOverflow (short size) {
+    if (size > MAX_LIMBS) {
+        raiseBigIntStatus(BIGINT_OVERFLOW);
+    }
+}
+
+//a result of size limbs can not be held at all (BigInt.size is a short): BIGINT_OVERFLOW is raised and FALSE returned,
+//the caller gives zero instead of letting the length wrap round into a tiny buffer
+bool checkLimbCount (long size) {
+    if (size > SHRT_MAX) {
+        raiseBigIntStatus(BIGINT_OVERFLOW);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+Stats layer : build with -DBIGINT_STATS
+--> counts calls and clock ticks per operation, allocations (count and bytes) made by the library, the deepest
+    Karatsuba recursion and the Karatsuba leaves that go to schoolbook, without -DBIGINT_STATS every STATS_ macro
+    is empty and the counters stay zero
+--> ticks are the time stamp counter on x86 and nanoseconds elsewhere, they are inclusive: subtracTwotBigInts calling
+    addTwoNumbers counts in both
+--> the counters are shared by all threads (relaxed atomic adds), getBigIntStats reads them, resetBigIntStats clears them
+    and dumpBigIntStats writes them as one json object, ./bigint ... --stats dumps them to stderr at exit
+*/
+typedef enum {STAT_ADD, STAT_SUB, STAT_MUL_SCHOOLBOOK, STAT_MUL_KARATSUBA, STAT_MUL, STAT_TOOM3, STAT_NTT, STAT_SQUARE,
+              STAT_ADDMUL, STAT_DIVMOD, STAT_BARRETT, STAT_MODPOW, STAT_GCD, STAT_PRIME, STAT_PARSE, STAT_PRINT, STAT_OP_COUNT} statOperation;
+
+const char* statOperationNames[STAT_OP_COUNT] = {"add", "sub", "mul_schoolbook", "mul_karatsuba", "mul", "toom3", "ntt",
+                                                 "square", "addmul", "divmod", "barrett", "modpow", "gcd", "prime", "parse", "print"};
+
+typedef struct bigIntStats {
+    uint64_t calls[STAT_OP_COUNT];
+    uint64_t ticks[STAT_OP_COUNT];
+    uint64_t allocations; //limb buffers and scratch blocks the library allocated
+    uint64_t allocatedBytes;
+    uint64_t karatsubaMaxDepth; //most Karatsuba splits seen on one path, 0 when Karatsuba never split
+    uint64_t karatsubaLeaves; //products at or below karatsubaThreshold handed to schoolbook
+} bigIntStats;
+
+bigIntStats statsTotals;
+
+#ifdef BIGINT_STATS
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include<x86intrin.h> //__rdtsc
+#define STATS_CLOCK "tsc"
+#else
+#define STATS_CLOCK "ns"
+#endif
+
+__thread uint64_t statsKaratsubaDepth; //splits above the current limbsKaratsuba call on this thread
+
+uint64_t statsClock () {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+void statsRecord (statOperation op, uint64_t start) {
+    __atomic_fetch_add(&statsTotals.calls[op], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&statsTotals.ticks[op], statsClock() - start, __ATOMIC_RELAXED);
+}
+
+void statsAllocation (size_t bytes) {
+    __atomic_fetch_add(&statsTotals.allocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&statsTotals.allocatedBytes, bytes, __ATOMIC_RELAXED);
+}
+
+void statsKaratsubaEnter () {
+    uint64_t depth = ++statsKaratsubaDepth;
+    uint64_t seen = __atomic_load_n(&statsTotals.karatsubaMaxDepth, __ATOMIC_RELAXED);
+    while (depth > seen && !__atomic_compare_exchange_n(&statsTotals.karatsubaMaxDepth, &seen, depth, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+#define STATS_BEGIN() uint64_t statsStart = statsClock()
+#define STATS_END(op) statsRecord(op, statsStart)
+#define STATS_ALLOC(bytes) statsAllocation(bytes)
+#define STATS_KARATSUBA_ENTER() statsKaratsubaEnter()
+#define STATS_KARATSUBA_EXIT() (statsKaratsubaDepth -= 1)
+#define STATS_KARATSUBA_LEAF() __atomic_fetch_add(&statsTotals.karatsubaLeaves, 1, __ATOMIC_RELAXED)
+#else
+#define STATS_CLOCK "off"
+#define STATS_BEGIN()
+#define STATS_END(op)
+#define STATS_ALLOC(bytes)
+#define STATS_KARATSUBA_ENTER()
+#define STATS_KARATSUBA_EXIT()
+#define STATS_KARATSUBA_LEAF()
+#endif
+
+//a snapshot of the counters, all zero when the stats layer is not built in
+bigIntStats getBigIntStats () {
+    bigIntStats snapshot;
+    const uint64_t* from = (const uint64_t*)&statsTotals;
+    uint64_t* to = (uint64_t*)&snapshot;
+    for (size_t i = 0; i < sizeof(bigIntStats) / sizeof(uint64_t); i++) {
+        to[i] = __atomic_load_n(&from[i], __ATOMIC_RELAXED);
+    }
+    return snapshot;
+}
+
+void resetBigIntStats () {
+    uint64_t* counters = (uint64_t*)&statsTotals;
+    for (size_t i = 0; i < sizeof(bigIntStats) / sizeof(uint64_t); i++) {
+        __atomic_store_n(&counters[i], 0, __ATOMIC_RELAXED);
+    }
+}
+
+//the counters as one json object on one line
+void dumpBigIntStats (FILE* out) {
+    bigIntStats s = getBigIntStats();
+
+    fprintf(out, "{\"clock\":\"%s\",\"operations\":{", STATS_CLOCK);
+    for (int op = 0; op < STAT_OP_COUNT; op++) {
+        fprintf(out, "%s\"%s\":{\"calls\":%llu,\"ticks\":%llu}", (op > 0) ? "," : "", statOperationNames[op],
+                (unsigned long long)s.calls[op], (unsigned long long)s.ticks[op]);
+    }
+    fprintf(out, "},\"allocations\":%llu,\"allocated_bytes\":%llu,\"karatsuba_max_depth\":%llu,\"karatsuba_leaves\":%llu}\n",
+            (unsigned long long)s.allocations, (unsigned long long)s.allocatedBytes,
+            (unsigned long long)s.karatsubaMaxDepth, (unsigned long long)s.karatsubaLeaves);
+    fflush(out);
+}
+
+void dumpBigIntStatsAtExit () {
+    dumpBigIntStats(stderr);
+}
+
 short max (short a, short b) {
     return (a > b) ? a : b;
 }
 
-short string_length (char *str) {
-    short length = 0;
+int string_length (char *str) { //int, decimal strings can be far longer than a short
+    int length = 0;
 
     //first digit denotes sign of the integer, so i starts from 1;
-    if (str != NULL) {
-        short i = 1;
+    if (str != NULL && str[0] != '\0') {
+        int i = 1;
         while (str[i] != '\0') {
             length += 1;
             i += 1;
@@ -50,13 +257,13 @@ short string_length (char *str) {
 
 bool isValidInput (char* str) { // to ensure given input contains only specified format
     bool ans = TRUE;
-    short i = 0, length;
+    int i = 0, length;
     length = string_length(str);
 
     if (str[i] == ' ' || str[i] == '+' || str[i] == '-') {
         i = i + 1;
         while (i != length && ans) {
-            if (str[i] < 48 || str[i] > 57) { // 0 - ascii value - 48 and 9 ascii value - 57 
+            if (str[i] < 48 || str[i] > 57) { // 0 - ascii value - 48 and 9 ascii value - 57
                 ans = FALSE;
             }
             i += 1;
@@ -70,7 +277,7 @@ bool isValidInput (char* str) { // to ensure given input contains only specified
 
 //This function is checked only when the input string is in valid form
 numSign signSpecifier (char *str) {
-    numSign sign;
+    numSign sign = POSITIVE; //a string without a sign character reads as positive
 
     if (str[0] == '+' || str[0] == ' ') {
         sign = POSITIVE;
@@ -81,73 +288,487 @@ numSign signSpecifier (char *str) {
     return sign;
 }
 
-void initializeBigInt (BigInt* b, short size, numSign sign) {
-    b -> digit_array = (uint8_t*) calloc(size , sizeof(uint8_t));
+//returns FALSE when the limbs cannot be allocated, b is then a zero with no limbs and BIGINT_NO_MEMORY is raised
+bool initializeBigInt (BigInt* b, short size, numSign sign) {
+    //atleast one limb is allocated so that zero sized numbers still own a valid buffer
+    b -> limb_array = (limb_t*) calloc(size > 0 ? size : 1, sizeof(limb_t));
 
-    if(b -> digit_array != NULL) { //safe side so that we dont get into segmentation fault by accesing null
+    if(b -> limb_array != NULL) { //safe side so that we dont get into segmentation fault by accesing null
+        STATS_ALLOC((size > 0 ? size : 1) * sizeof(limb_t));
         b -> sign = sign;
         b -> size = size;
-    } else {
-        free(b -> digit_array);
-        b -> digit_array = NULL;
-        printf("memory allocation failed.\n");
-        exit(EXIT_FAILURE); //stops execution and exits status is failure(1)
+        b -> capacity = size > 0 ? size : 1;
+        return TRUE;
     }
+    b -> sign = POSITIVE;
+    b -> size = 0;
+    b -> capacity = 0;
+    raiseBigIntStatus(BIGINT_NO_MEMORY);
+    return FALSE;
 }
 
-BigInt readNumFromString (char *str) {
-    BigInt b;
-    numSign sign = signSpecifier(str);
-    short length = string_length(str);
-    initializeBigInt(&b, length, sign);
-    short i = 1;
+//brings b into the canonical form every function returns: size is the number of limbs actually used (the top limb is
+//never zero) and zero has size 0 and a positive sign, comparisons, zero tests and bit lengths rely on it
+//a BigInt filled in by hand goes through here before it is handed to the library
+void trimBigInt (BigInt* b) {
+    while (b -> size > 0 && b -> limb_array[b -> size - 1] == 0) {
+        b -> size -= 1;
+    }
+    if (b -> size == 0) {
+        b -> sign = POSITIVE;
+    }
+}
+
+//a = a * m + add, over the first size limbs of a, returns the limb carried out of the top
+limb_t limbsMulSmallAdd (limb_t* a, short size, limb_t m, limb_t add) {
+    dlimb_t carry = add;
 
-    while (str[i] != '\0') {
-        uint8_t digit = str[i] - '0';
-        b.digit_array[i-1] = digit;
-        i += 1;
+    for (short i = 0; i < size; i++) {
+        dlimb_t t = (dlimb_t)a[i] * m + carry;
+        a[i] = (limb_t)t;
+        carry = t >> LIMB_BITS;
     }
-    return b;
+
+    return (limb_t)carry;
 }
 
-//sign not considered
-compareStatus compareMagnitude (BigInt b1, BigInt b2) {
-    compareStatus cs;
+//a = a / d, over the first size limbs of a, returns the remainder
+limb_t limbsDivSmall (limb_t* a, short size, limb_t d) {
+    dlimb_t rem = 0;
 
-    if (b1.size > b2.size) {
-        cs = LARGE;
-    } else if (b1.size < b2.size) {
-        cs = SMALL;
+    for (short i = size - 1; i >= 0; i--) {
+        dlimb_t cur = (rem << LIMB_BITS) | a[i];
+        a[i] = (limb_t)(cur / d);
+        rem = cur % d;
+    }
+
+    return (limb_t)rem;
+}
+
+/*
+Limb kernels with runtime CPU dispatch
+--> limbsUsed, limbsAddN, limbsSubN and limbsCompareN are function pointers, they start on the portable scalar
+    versions and selectLimbKernels switches them to the AVX2 versions at startup when the CPU has AVX2
+--> AVX2 add works on 8 limbs at once: lanes are added without carries, then each lane reports whether it overflowed
+    (generate) or is all ones and would pass an incoming carry on (propagate). With those two 8 bit masks the carry
+    into every lane is ((generate << 1 | carryIn) + propagate) ^ propagate, one integer add instead of 8 dependent steps
+--> subtraction is the same with borrows (generate: b > a, propagate: difference is zero)
+--> compare and zero scans test 8 limbs per step from the top
+*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BIGINT_X86_DISPATCH
+#include<immintrin.h>
+#endif
+
+//number of limbs of a that are actually used, leading zero limbs are not counted
+short limbsUsedScalar (const limb_t* a, short size) {
+    while (size > 0 && a[size - 1] == 0) {
+        size -= 1;
+    }
+    return size;
+}
+
+//r = a + b + carry over n limbs each, r may be the same array as a or b, returns the carry out of the top limb
+limb_t limbsAddNScalar (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t carry) {
+    for (short i = 0; i < n; i++) {
+        dlimb_t limbSum = (dlimb_t)a[i] + b[i] + carry;
+        r[i] = (limb_t)limbSum;
+        carry = (limb_t)(limbSum >> LIMB_BITS);
+    }
+    return carry;
+}
+
+//r = a - b - borrow over n limbs each, r may be the same array as a or b, returns the borrow out of the top limb
+limb_t limbsSubNScalar (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t borrow) {
+    for (short i = 0; i < n; i++) {
+        dlimb_t limbDiff = (dlimb_t)a[i] - b[i] - borrow;
+        r[i] = (limb_t)limbDiff;
+        borrow = (limb_t)(limbDiff >> LIMB_BITS) & 1; //wrapped around means we borrowed from next limb
+    }
+    return borrow;
+}
+
+//compares two n limb arrays from the top limb down
+compareStatus limbsCompareNScalar (const limb_t* a, const limb_t* b, short n) {
+    short i = n - 1;
+    while (i >= 0 && a[i] == b[i]) {
+        i = i - 1;
+    }
+    if (i < 0) {
+        return EQUAL;
+    }
+    return (a[i] > b[i]) ? LARGE : SMALL;
+}
+
+#ifdef BIGINT_X86_DISPATCH
+__attribute__((target("avx2")))
+short limbsUsedAvx2 (const limb_t* a, short size) {
+    while (size >= 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(a + size - 8));
+        if (!_mm256_testz_si256(v, v)) {
+            break;
+        }
+        size -= 8;
+    }
+    return limbsUsedScalar(a, size);
+}
+
+//adds the carry bit of every lane selected in carries (bit i = lane i) to v
+__attribute__((target("avx2")))
+static inline __m256i laneIncrement (__m256i v, unsigned carries) {
+    const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i selected = _mm256_and_si256(_mm256_set1_epi32((int)carries), laneBits);
+    return _mm256_sub_epi32(v, _mm256_cmpeq_epi32(selected, laneBits)); //a selected lane is -1, so this adds 1
+}
+
+//takes the borrow bit of every lane selected in borrows away from v
+__attribute__((target("avx2")))
+static inline __m256i laneDecrement (__m256i v, unsigned borrows) {
+    const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i selected = _mm256_and_si256(_mm256_set1_epi32((int)borrows), laneBits);
+    return _mm256_add_epi32(v, _mm256_cmpeq_epi32(selected, laneBits));
+}
+
+__attribute__((target("avx2")))
+limb_t limbsAddNAvx2 (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t carry) {
+    const __m256i signBit = _mm256_set1_epi32((int)0x80000000u);
+    const __m256i allOnes = _mm256_set1_epi32(-1);
+    short i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i sum = _mm256_add_epi32(va, vb);
+        //unsigned compare through the sign bit flip: sum < a means the lane wrapped around
+        __m256i generate = _mm256_cmpgt_epi32(_mm256_xor_si256(va, signBit), _mm256_xor_si256(sum, signBit));
+        __m256i propagate = _mm256_cmpeq_epi32(sum, allOnes);
+        unsigned g = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(generate));
+        unsigned p = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(propagate));
+        unsigned t = ((g << 1) | carry) + p;
+
+        _mm256_storeu_si256((__m256i*)(r + i), laneIncrement(sum, (t ^ p) & 0xFF));
+        carry = (t >> 8) & 1;
+    }
+    return limbsAddNScalar(r + i, a + i, b + i, n - i, carry);
+}
+
+__attribute__((target("avx2")))
+limb_t limbsSubNAvx2 (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t borrow) {
+    const __m256i signBit = _mm256_set1_epi32((int)0x80000000u);
+    const __m256i zero = _mm256_setzero_si256();
+    short i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        __m256i diff = _mm256_sub_epi32(va, vb);
+        __m256i generate = _mm256_cmpgt_epi32(_mm256_xor_si256(vb, signBit), _mm256_xor_si256(va, signBit));
+        __m256i propagate = _mm256_cmpeq_epi32(diff, zero);
+        unsigned g = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(generate));
+        unsigned p = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(propagate));
+        unsigned t = ((g << 1) | borrow) + p;
+
+        _mm256_storeu_si256((__m256i*)(r + i), laneDecrement(diff, (t ^ p) & 0xFF));
+        borrow = (t >> 8) & 1;
+    }
+    return limbsSubNScalar(r + i, a + i, b + i, n - i, borrow);
+}
+
+__attribute__((target("avx2")))
+compareStatus limbsCompareNAvx2 (const limb_t* a, const limb_t* b, short n) {
+    while (n >= 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + n - 8));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + n - 8));
+        unsigned equal = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(va, vb)));
+        if (equal != 0xFF) {
+            short lane = 31 - __builtin_clz(~equal & 0xFF); //highest lane that differs
+            return (a[n - 8 + lane] > b[n - 8 + lane]) ? LARGE : SMALL;
+        }
+        n -= 8;
+    }
+    return limbsCompareNScalar(a, b, n);
+}
+#endif
+
+short (*limbsUsed) (const limb_t* a, short size) = limbsUsedScalar;
+limb_t (*limbsAddN) (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t carry) = limbsAddNScalar;
+limb_t (*limbsSubN) (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t borrow) = limbsSubNScalar;
+compareStatus (*limbsCompareN) (const limb_t* a, const limb_t* b, short n) = limbsCompareNScalar;
+const char* limbKernelName = "scalar";
+
+//points the dispatched kernels at the best versions this CPU supports, allowSimd = FALSE forces the scalar ones
+void selectLimbKernels (bool allowSimd) {
+    limbsUsed = limbsUsedScalar;
+    limbsAddN = limbsAddNScalar;
+    limbsSubN = limbsSubNScalar;
+    limbsCompareN = limbsCompareNScalar;
+    limbKernelName = "scalar";
+#ifdef BIGINT_X86_DISPATCH
+    __builtin_cpu_init();
+    if (allowSimd && __builtin_cpu_supports("avx2")) {
+        limbsUsed = limbsUsedAvx2;
+        limbsAddN = limbsAddNAvx2;
+        limbsSubN = limbsSubNAvx2;
+        limbsCompareN = limbsCompareNAvx2;
+        limbKernelName = "avx2";
+    }
+#else
+    (void)allowSimd;
+#endif
+}
+
+#ifdef BIGINT_X86_DISPATCH
+//runs before main, so every caller sees the selected kernels
+__attribute__((constructor)) void selectLimbKernelsAtStartup () {
+    selectLimbKernels(TRUE);
+}
+#endif
+
+//r = a + b for an >= bn, r needs room for an limbs and may be the same array as a or b, returns the carry out of the top limb
+limb_t limbsAdd (limb_t* r, const limb_t* a, short an, const limb_t* b, short bn) {
+    limb_t carry = limbsAddN(r, a, b, bn, 0);
+
+    for (short i = bn; i < an; i++) {
+        dlimb_t limbSum = (dlimb_t)a[i] + carry;
+        r[i] = (limb_t)limbSum;
+        carry = (limb_t)(limbSum >> LIMB_BITS);
+    }
+
+    return carry;
+}
+
+//r = a - b for an >= bn, r needs room for an limbs and may be the same array as a or b, returns 1 if b was larger than a
+limb_t limbsSub (limb_t* r, const limb_t* a, short an, const limb_t* b, short bn) {
+    limb_t borrow = limbsSubN(r, a, b, bn, 0);
+
+    for (short i = bn; i < an; i++) {
+        dlimb_t limbDiff = (dlimb_t)a[i] - borrow;
+        r[i] = (limb_t)limbDiff;
+        borrow = (limb_t)(limbDiff >> LIMB_BITS) & 1;
+    }
+
+    return borrow;
+}
+
+//compares two limb arrays by value, leading zero limbs are ignored
+compareStatus limbsCompare (const limb_t* a, short an, const limb_t* b, short bn) {
+    an = limbsUsed(a, an);
+    bn = limbsUsed(b, bn);
+
+    if (an != bn) {
+        return (an > bn) ? LARGE : SMALL;
+    }
+    return limbsCompareN(a, b, an);
+}
+
+//r = a + b with signs, r needs max(an, bn) + 1 limbs and may be the same array as a or b, returns the number of limbs used by r
+short limbsSignedAdd (limb_t* r, numSign* rSign, const limb_t* a, short an, numSign aSign, const limb_t* b, short bn, numSign bSign) {
+    an = limbsUsed(a, an);
+    bn = limbsUsed(b, bn);
+
+    //the larger operand goes first so the kernels can run the carry / borrow through its extra limbs
+    bool swap = (aSign == bSign) ? (an < bn) : (limbsCompare(a, an, b, bn) == SMALL);
+    if (swap) {
+        const limb_t* t = a;
+        a = b;
+        b = t;
+        short tn = an;
+        an = bn;
+        bn = tn;
+        numSign ts = aSign;
+        aSign = bSign;
+        bSign = ts;
+    }
+
+    short size;
+    if (aSign == bSign) {
+        r[an] = limbsAdd(r, a, an, b, bn);
+        size = limbsUsed(r, an + 1);
     } else {
-        short size = b1.size;
-        short i = 0;
-        while (i < size && b1.digit_array[i] == b2.digit_array[i]) {
-            i = i + 1;
+        //signs differ, subtract the smaller magnitude from the larger one and keep the larger one's sign
+        limbsSub(r, a, an, b, bn);
+        size = limbsUsed(r, an);
+    }
+    *rSign = (size == 0) ? POSITIVE : aSign;
+    return size;
+}
+
+//r = a * b, r needs room for an + bn limbs and must not overlap a or b
+//product scanning (Comba): column k of the result sums every a[i] * b[k - i] into a three limb accumulator
+//(acc holds the low two limbs, accHigh counts the overflows out of acc), so each result limb is written exactly once
+void limbsMul (limb_t* r, const limb_t* a, short an, const limb_t* b, short bn) {
+    dlimb_t acc = 0;
+    limb_t accHigh = 0;
+
+    for (short k = 0; k < an + bn - 1; k++) {
+        short iStart = (k < bn) ? 0 : k - bn + 1;
+        short iEnd = (k < an) ? k : an - 1;
+
+        for (short i = iStart; i <= iEnd; i++) {
+            dlimb_t product = (dlimb_t)a[i] * b[k - i];
+            acc += product;
+            accHigh += (acc < product); //acc wrapped around
         }
-        if (i == size) {
-            cs = EQUAL;
-        } else if (b1.digit_array[i] > b2.digit_array[i]) {
-            cs = LARGE;
-        } else if (b1.digit_array[i] < b2.digit_array[i]) {
-            cs = SMALL;
+        r[k] = (limb_t)acc;
+        acc = (acc >> LIMB_BITS) | ((dlimb_t)accHigh << LIMB_BITS);
+        accHigh = 0;
+    }
+    if (an + bn > 0) {
+        r[an + bn - 1] = (limb_t)acc;
+    }
+}
+
+//r = a * a, r needs room for 2 * n limbs and must not overlap a
+//every cross product a[i] * a[j] (i < j) appears twice in a square, so each column adds it once, doubles the column
+//and then adds the diagonal a[k / 2]^2, that is about half the limb multiplies of limbsMul
+void limbsSqr (limb_t* r, const limb_t* a, short n) {
+    dlimb_t acc = 0;
+    limb_t accHigh = 0;
+
+    for (short k = 0; k < 2 * n - 1; k++) {
+        short iStart = (k < n) ? 0 : k - n + 1;
+        dlimb_t cross = 0;
+        limb_t crossHigh = 0;
+
+        for (short i = iStart; i < k - i; i++) {
+            dlimb_t product = (dlimb_t)a[i] * a[k - i];
+            cross += product;
+            crossHigh += (cross < product);
+        }
+        crossHigh = (crossHigh << 1) | (limb_t)(cross >> (2 * LIMB_BITS - 1));
+        cross <<= 1;
+        if ((k & 1) == 0) {
+            dlimb_t product = (dlimb_t)a[k / 2] * a[k / 2];
+            cross += product;
+            crossHigh += (cross < product);
         }
+
+        acc += cross;
+        accHigh += crossHigh + (acc < cross);
+        r[k] = (limb_t)acc;
+        acc = (acc >> LIMB_BITS) | ((dlimb_t)accHigh << LIMB_BITS);
+        accHigh = 0;
+    }
+    if (n > 0) {
+        r[2 * n - 1] = (limb_t)acc;
     }
+}
 
-    return cs;
+//number of zero bits above the highest set bit of x, x must be non zero
+short limbLeadingZeros (limb_t x) {
+    short n = 0;
+    for (short step = LIMB_BITS / 2; step > 0; step /= 2) {
+        if ((x >> (LIMB_BITS - step)) == 0) {
+            n += step;
+            x <<= step;
+        }
+    }
+    return n;
+}
+
+//limbs of scratch space limbsDivRem needs for an an limb dividend and a dn limb divisor
+int limbsDivRemScratch (short an, short dn) {
+    return an + 1 + dn;
+}
+
+//long division with Knuth's Algorithm D (TAOCP vol 2, 4.3.1): q = a / d and rem = a % d
+//q needs an limbs, rem needs dn limbs, scratch needs limbsDivRemScratch(an, dn) limbs, d must be non zero
+//returns the number of limbs used by the remainder
+short limbsDivRem (limb_t* q, limb_t* rem, const limb_t* a, short an, const limb_t* d, short dn, limb_t* scratch) {
+    memset(q, 0, an * sizeof(limb_t));
+    an = limbsUsed(a, an);
+    dn = limbsUsed(d, dn);
+
+    //dividend smaller than divisor, quotient is zero and the whole dividend is the remainder
+    if (an < dn) {
+        memmove(rem, a, an * sizeof(limb_t));
+        return an;
+    }
+
+    //single limb divisor, one hardware division per limb is enough
+    if (dn == 1) {
+        memcpy(q, a, an * sizeof(limb_t));
+        rem[0] = limbsDivSmall(q, an, d[0]);
+        return (rem[0] != 0) ? 1 : 0;
+    }
+
+    //normalize: shift both so the top bit of the divisor is set, then every quotient estimate is off by atmost 2
+    short shift = limbLeadingZeros(d[dn - 1]);
+    limb_t* un = scratch; //an + 1 limbs
+    limb_t* vn = un + an + 1; //dn limbs
+    for (short i = dn - 1; i > 0; i--) {
+        vn[i] = (d[i] << shift) | (shift ? d[i - 1] >> (LIMB_BITS - shift) : 0);
+    }
+    vn[0] = d[0] << shift;
+    un[an] = shift ? a[an - 1] >> (LIMB_BITS - shift) : 0;
+    for (short i = an - 1; i > 0; i--) {
+        un[i] = (a[i] << shift) | (shift ? a[i - 1] >> (LIMB_BITS - shift) : 0);
+    }
+    un[0] = a[0] << shift;
+
+    for (short j = an - dn; j >= 0; j--) {
+        //estimate the quotient limb from the top two limbs of the remainder and the top limb of the divisor
+        dlimb_t top = ((dlimb_t)un[j + dn] << LIMB_BITS) | un[j + dn - 1];
+        dlimb_t qhat = top / vn[dn - 1];
+        dlimb_t rhat = top % vn[dn - 1];
+
+        //correct the estimate with the next limb of the divisor, this catches almost every overestimate
+        while (qhat >= BASE || qhat * vn[dn - 2] > ((rhat << LIMB_BITS) | un[j + dn - 2])) {
+            qhat -= 1;
+            rhat += vn[dn - 1];
+            if (rhat >= BASE) {
+                break;
+            }
+        }
+
+        //un[j .. j + dn] -= qhat * vn
+        int64_t borrow = 0;
+        int64_t t;
+        for (short i = 0; i < dn; i++) {
+            dlimb_t p = qhat * vn[i];
+            t = (int64_t)un[i + j] - borrow - (int64_t)(p & 0xFFFFFFFFu);
+            un[i + j] = (limb_t)t;
+            borrow = (int64_t)(p >> LIMB_BITS) - (t >> LIMB_BITS);
+        }
+        t = (int64_t)un[j + dn] - borrow;
+        un[j + dn] = (limb_t)t;
+
+        //estimate was still one too large (rare), add the divisor back once
+        if (t < 0) {
+            qhat -= 1;
+            limb_t carry = limbsAdd(un + j, un + j, dn, vn, dn);
+            un[j + dn] += carry;
+        }
+        q[j] = (limb_t)qhat;
+    }
+
+    //remainder is un shifted back down
+    for (short i = 0; i < dn - 1; i++) {
+        rem[i] = (un[i] >> shift) | (shift ? un[i + 1] << (LIMB_BITS - shift) : 0);
+    }
+    rem[dn - 1] = un[dn - 1] >> shift;
+
+    return limbsUsed(rem, dn);
+}
+
+//sign not considered, the sizes are exact so different sizes answer at once and equal ones compare from the top limb
+compareStatus compareMagnitude (BigInt b1, BigInt b2) {
+    if (b1.size != b2.size) {
+        return (b1.size > b2.size) ? LARGE : SMALL;
+    }
+    return limbsCompareN(b1.limb_array, b2.limb_array, b1.size);
 }
 
 //sign considered
 compareStatus compareNumbers (BigInt b1, BigInt b2) {
     compareStatus cs;
-    
+
     //positive is always larger than negative
     if (b1.sign == POSITIVE && b2.sign == NEGATIVE) {
         cs = LARGE;
     } else if (b1.sign == NEGATIVE && b2.sign == POSITIVE) {
         cs = SMALL;
-    }
-
-    if (b1.sign == POSITIVE) {
+    } else if (b1.sign == POSITIVE) {
         cs =  compareMagnitude(b1, b2);
     } else {
         compareStatus result = compareMagnitude(b1, b2);
@@ -164,121 +785,61 @@ compareStatus compareNumbers (BigInt b1, BigInt b2) {
 }
 
 bool isBigIntZero (BigInt b) {
-    short i = 0;
-    bool ans;
-
-    while (i < b.size && b.digit_array[i] == 0) {
-        i++;
-    }
+    return (b.size == 0) ? TRUE : FALSE;
+}
 
-    if(i == b.size) {
-        ans = TRUE;
-    } else {
-        ans = FALSE;
+//bits up to and including the highest set bit of |b|, 0 for zero, read off the top limb of the canonical form
+int bigIntBitLength (BigInt b) {
+    if (b.size == 0) {
+        return 0;
     }
-
-    return ans;
+    return b.size * LIMB_BITS - limbLeadingZeros(b.limb_array[b.size - 1]);
 }
 
 short size_diff (BigInt b1, BigInt b2) {
     return abs(b1.size - b2.size);
 }
 
-//function assumes that b1 > b2
+//function assumes that |b1| >= |b2|
 BigInt subraction (BigInt b1, BigInt b2, short size, numSign sign) {
-    if (size > MAX_DIGITS) {
-        printf("Overflow Warning: Subtraction result size %d exceeds max allowed %d digits.\n", size, MAX_DIGITS);
-    }
     BigInt b;
-    initializeBigInt(&b, size, sign);
-    short i = b1.size - 1;
-    short j = b2.size - 1;
-    short sizeDiff = size_diff(b1, b2);
-    uint8_t borrow = 0;
-
-    while (i >= 0 && j >= 0) {
-        int8_t digitDiff = b1.digit_array[i] - b2.digit_array[j] - borrow;
-        if (digitDiff < 0) {
-            borrow = 1;
-            digitDiff += 10;
-        } else {
-            borrow = 0;
-        }
-        b.digit_array[i] = digitDiff; 
-        i -= 1;
-        j -= 1;
-    }
-
-    while (i >= 0) {
-        int8_t digitDiff = b1.digit_array[i] - borrow;
-        if (digitDiff < 0) {
-            borrow = 1;
-            digitDiff += 10;
-        } else {
-            borrow = 0;
-        }
-        b.digit_array[i] = digitDiff; 
-        i -= 1;
+    if (!initializeBigInt(&b, max(size, b1.size), sign)) {
+        return b;
     }
-    //as arg1 > arg2 so we dont check for j as j will always approach zero first
+    //as arg1 >= arg2 the top limbs of b2 beyond b1.size are all zero and never borrowed from
+    limbsSub(b.limb_array, b1.limb_array, b1.size, b2.limb_array, limbsUsed(b2.limb_array, b2.size));
 
+    trimBigInt(&b);
+    checkOverflow(b.size);
     return b;
 }
 
 BigInt addTwoNumbers (BigInt b1, BigInt b2) {
+    STATS_BEGIN();
     BigInt b;
     numSign sign;
-    compareStatus cs1, cs;
-
-    cs1 = compareNumbers(b1, b2);
-    cs = compareMagnitude(b1, b2);
+    compareStatus cs;
 
     if (b1.sign == b2.sign) {
-        short sizeDiff = size_diff(b1, b2);
-        short length = max(b1.size, b2.size) + 1; // extra 1 block for carry. if carry exists actually it overflows so to prevent overflow extra one block
-        if (length > MAX_DIGITS) {
-            printf("Overflow Warning: Addition result exceeds %d digits.\n", MAX_DIGITS);
-        }
+        short length = max(b1.size, b2.size) + 1; // extra 1 limb for carry out of the top limb
         sign = b1.sign;
-        initializeBigInt(&b, length, sign);
-        short size;
-        size = max(b1.size, b1.size);
-        short i = b1.size - 1;
-        uint8_t carry = 0;
-        short j = b2.size - 1;
-
-        while (i >= 0 && j >= 0) {
-            uint8_t digitSum = b1.digit_array[i] + b2.digit_array[j] + carry;
-            uint8_t digit = digitSum % 10;
-            short k = (b1.size > b2.size) ? i : j;
-            b.digit_array[k + 1] = digit;
-            carry = digitSum / 10;
-            i -= 1;
-            j -= 1;
-        }
-        while (i >= 0) {
-            uint8_t digitSum = b1.digit_array[i] + carry;
-            uint8_t digit = digitSum % 10;
-            b.digit_array[i + 1] = digit;
-            carry = digitSum / 10;
-            i -= 1;
-        }
-        while (j >= 0) {
-            uint8_t digitSum = b2.digit_array[j] + carry;
-            uint8_t digit = digitSum % 10;
-            b.digit_array[j + 1] = digit;
-            carry = digitSum / 10;
-            j -= 1;
+        if (!initializeBigInt(&b, length, sign)) {
+            STATS_END(STAT_ADD);
+            return b;
         }
 
-        short k = (b1.size > b2.size) ? i : j;
-        if (carry) {
-            b.digit_array[k + 1] = 1;
+        //the longer operand goes first so the kernel can run the carry through its extra limbs
+        if (b1.size >= b2.size) {
+            b.limb_array[b1.size] = limbsAdd(b.limb_array, b1.limb_array, b1.size, b2.limb_array, b2.size);
         } else {
-            b.digit_array[k + 1] = 0;
+            b.limb_array[b2.size] = limbsAdd(b.limb_array, b2.limb_array, b2.size, b1.limb_array, b1.size);
         }
+
+        trimBigInt(&b);
+        checkOverflow(b.size);
     } else {
         short length = max(b1.size, b2.size); //the max size could not exceed maximum of two numbers in subraction
+        cs = compareMagnitude(b1, b2);
 
         if (b1.sign == POSITIVE && b2.sign == NEGATIVE) {
             if (cs == LARGE || cs == EQUAL) {
@@ -299,12 +860,14 @@ BigInt addTwoNumbers (BigInt b1, BigInt b2) {
         }
     }
 
+    STATS_END(STAT_ADD);
     return b;
 }
 
 BigInt subtracTwotBigInts (BigInt b1, BigInt b2) {
+    STATS_BEGIN();
     BigInt b;
-    short length = max(b1.size, b2.size); 
+    short length = max(b1.size, b2.size);
     compareStatus cs = compareMagnitude(b1, b2);
     numSign resultSign;
 
@@ -343,326 +906,5915 @@ BigInt subtracTwotBigInts (BigInt b1, BigInt b2) {
         }
     }
 
+    STATS_END(STAT_SUB);
     return b;
 }
 
-//I store the whole result in a bigint structure in which array could have maximum size of 618(309 + 309)
+//I store the whole result in a bigint structure in which array could have maximum size of 64 limbs(32 + 32)
 BigInt multiplyTwoBigInt (BigInt b1, BigInt b2) {
+    STATS_BEGIN();
     BigInt b;
     numSign sign = b1.sign ^ b2.sign;
+    if (!checkLimbCount((long)b1.size + b2.size)) {
+        STATS_END(STAT_MUL_SCHOOLBOOK);
+        initializeBigInt(&b, 0, POSITIVE);
+        return b;
+    }
     short size = b1.size + b2.size;
-    if (size > MAX_DIGITS) {
-        printf("Overflow Warning: result size exceeds MAX_DIGITS\n");
-    }
-    initializeBigInt(&b, size, sign);
-    b.sign = POSITIVE;
-    short size1 = b1.size;
-    short size2 = b2.size;
-    short extraSpacing = 0;
-
-    for (short i = size2 - 1; i >= 0; i--) {
-        BigInt pb;
-        //array with extraspacing, the extra spacing has zeroes because as we shift left by 1 and add 0 at right and continues this method
-        if (size1 + 1 + extraSpacing > MAX_DIGITS) {
-            printf("Overflow Warning: partial product size exceeds MAX_DIGITS\n");
-        }
-        initializeBigInt(&pb, size1 + 1 + extraSpacing, POSITIVE);
-        int8_t carry = 0;
-        short j;
-        short ind = pb.size - 1 - extraSpacing;
-        for (j = size1 - 1; j >= 0; j--)  {
-            int8_t digitMulti = (b2.digit_array[i] * b1.digit_array[j]) + carry; 
-            pb.digit_array[ind] = digitMulti % 10;
-            carry = digitMulti / 10;
-            ind--;
-            if (ind < 0 && (j > 0 || carry > 0)) {
-                printf("Index overflow in multiplication loop\n");
-            }
-        }
-        if (carry != 0) {
-            if (ind < 0) {
-                printf("Index overflow while placing carry\n");
-            }
-            pb.digit_array[ind] = carry;
-            ind--;
-        }
-        extraSpacing += 1;
-        b = addTwoNumbers(b, pb);
-        free (pb.digit_array);
+    if (initializeBigInt(&b, size, sign)) {
+        limbsMul(b.limb_array, b1.limb_array, b1.size, b2.limb_array, b2.size);
     }
-    b.sign = sign;
 
+    trimBigInt(&b);
+    checkOverflow(b.size);
+
+    STATS_END(STAT_MUL_SCHOOLBOOK);
     return b;
 }
 
 void freeBigInt(BigInt *b) {
-    if (b == NULL) return;    
-    if (b->digit_array != NULL) {
-        free(b->digit_array);
-        b->digit_array = NULL;  
+    if (b == NULL) return;
+    if (b->limb_array != NULL) {
+        free(b->limb_array);
+        b->limb_array = NULL;
     }
     b->size = 0;
+    b->capacity = 0;
     b->sign = POSITIVE;
 }
 
+//multiplies b by BASE^n, i.e. moves every limb n places up
 BigInt shiftLeft(BigInt b, int n) {
     BigInt res;
-    initializeBigInt(&res, b.size + n, b.sign);
-    memset(res.digit_array + res.size - n, 0, n);
+    if (!initializeBigInt(&res, b.size + n, b.sign)) {
+        return res;
+    }
 
     for (int i = 0; i < b.size; i++) {
-        res.digit_array[i] = b.digit_array[i];
+        res.limb_array[i + n] = b.limb_array[i];
     }
+    trimBigInt(&res); //zero stays zero instead of n zero limbs
     return res;
 }
 
-// Karatsuba multiplication recursive
-BigInt karatsubaMultiply(BigInt x, BigInt y) {
-    int n = x.size > y.size ? x.size : y.size;
-
-    // Base case: use naive multiplication for small numbers
-    if (n <= KARATSUBA_THRESHOLD) {
-        return multiplyTwoBigInt(x, y);
-    }
+//operands of atmost this many limbs are multiplied with the schoolbook kernel
+//set it once at startup (or build with -DBIGINT_TUNED), scratch sizes depend on it so it must not change while multiplies are running
+short karatsubaThreshold = KARATSUBA_THRESHOLD;
 
-    int half = n / 2;
+void setKaratsubaThreshold (short threshold) {
+    karatsubaThreshold = max(threshold, KARATSUBA_MIN_THRESHOLD);
+}
 
-    // Split x into high and low parts
-    BigInt x_high, x_low;
-    initializeBigInt(&x_high, x.size - half > 0 ? x.size - half : 0, POSITIVE);
-    initializeBigInt(&x_low, half, POSITIVE);
+short getKaratsubaThreshold () {
+    return karatsubaThreshold;
+}
 
-    memcpy(x_high.digit_array, x.digit_array, (x.size - half) * sizeof(uint8_t));
-    memcpy(x_low.digit_array, x.digit_array + x.size - half, half * sizeof(uint8_t));
+//limbs of scratch space limbsKaratsuba needs for two n limb operands
+//every level keeps x_sum, y_sum (half + 1 limbs each) and z1 (2 * (half + 1) limbs), the next level starts right after them
+int limbsKaratsubaScratch (short n) {
+    if (n <= karatsubaThreshold) {
+        return 0;
+    }
+    short high = n - n / 2;
+    return 4 * (high + 1) + limbsKaratsubaScratch(high + 1);
+}
 
-    // Split y into high and low parts
-    BigInt y_high, y_low;
-    initializeBigInt(&y_high, y.size - half > 0 ? y.size - half : 0, POSITIVE);
-    initializeBigInt(&y_low, half, POSITIVE);
+// Karatsuba multiplication recursive, r = a * b for two n limb operands
+// r needs 2 * n limbs and must not overlap a or b, scratch needs limbsKaratsubaScratch(n) limbs
+// nothing is allocated, every temporary of every level is carved out of scratch
+void limbsKaratsuba (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t* scratch) {
+    // Base case: use naive multiplication for small numbers
+    if (n <= karatsubaThreshold) {
+        STATS_KARATSUBA_LEAF();
+        limbsMul(r, a, n, b, n);
+        return;
+    }
+    STATS_KARATSUBA_ENTER();
 
-    memcpy(y_high.digit_array, y.digit_array, (y.size - half) * sizeof(uint8_t));
-    memcpy(y_low.digit_array, y.digit_array + y.size - half, half * sizeof(uint8_t));
+    // low part holds the least significant half limbs, high part the remaining (high >= half) limbs
+    short half = n / 2;
+    short high = n - half;
+    limb_t* x_sum = scratch;
+    limb_t* y_sum = x_sum + high + 1;
+    limb_t* z1 = y_sum + high + 1;
+    limb_t* next = z1 + 2 * (high + 1);
 
-    // Compute three products recursively
-    BigInt z0 = karatsubaMultiply(x_low, y_low);
-    BigInt z2 = karatsubaMultiply(x_high, y_high);
+    // z0 = x_low * y_low and z2 = x_high * y_high are computed straight into their final place in r
+    limbsKaratsuba(r, a, b, half, next);
+    limbsKaratsuba(r + 2 * half, a + half, b + half, high, next);
 
-    BigInt x_sum = addTwoNumbers(x_low, x_high);
-    BigInt y_sum = addTwoNumbers(y_low, y_high);
-    BigInt z1 = karatsubaMultiply(x_sum, y_sum);
+    // z1 = (x_low + x_high) * (y_low + y_high)
+    x_sum[high] = limbsAdd(x_sum, a + half, high, a, half);
+    y_sum[high] = limbsAdd(y_sum, b + half, high, b, half);
+    limbsKaratsuba(z1, x_sum, y_sum, high + 1, next);
 
     // z1 = z1 - z2 - z0
-    BigInt temp = subtracTwotBigInts(z1, z2);
-    BigInt z1_final = subtracTwotBigInts(temp, z0);
+    limbsSub(z1, z1, 2 * (high + 1), r, 2 * half);
+    limbsSub(z1, z1, 2 * (high + 1), r + 2 * half, 2 * high);
 
     // Combine results:
-    // result = z2 * BASE^{2*half} + z1 * BASE^{half} + z0
-
-    BigInt z2_shift = shiftLeft(z2, 2 * half);
-    BigInt z1_shift = shiftLeft(z1_final, half);
-
-    BigInt temp_sum = addTwoNumbers(z2_shift, z1_shift);
-    BigInt result = addTwoNumbers(temp_sum, z0);
-
-    // Set sign
-    result.sign = x.sign ^ y.sign;
-
-    // Free temporaries
-    freeBigInt(&x_high);
-    freeBigInt(&x_low);
-    freeBigInt(&y_high);
-    freeBigInt(&y_low);
-    freeBigInt(&z0);
-    freeBigInt(&z1);
-    freeBigInt(&z2);
-    freeBigInt(&x_sum);
-    freeBigInt(&y_sum);
-    freeBigInt(&temp);
-    freeBigInt(&z1_final);
-    freeBigInt(&z2_shift);
-    freeBigInt(&z1_shift);
-    freeBigInt(&temp_sum);
-
-    return result;
+    // result = z2 * BASE^{2*half} + z1 * BASE^{half} + z0, where z0 and z2 are already in place
+    limbsAdd(r + half, r + half, 2 * n - half, z1, 2 * (high + 1));
+    STATS_KARATSUBA_EXIT();
 }
 
-BigInt divideBigInt(BigInt dividend, BigInt divisor) {
-    if (isBigIntZero(divisor)) {
-        printf("Error: Division by zero\n");
-        BigInt result;
-        initializeBigInt(&result, 1, POSITIVE);
-        result.digit_array[0] = 0;
-        return result;
-    }
-    BigInt quotient;
-    initializeBigInt(&quotient, dividend.size, POSITIVE);
-    
-    if (compareMagnitude(dividend, divisor) == SMALL) {
-        quotient.digit_array[0] = 0;
-        quotient.size = 1;
-        return quotient;
+// Karatsuba squaring, r = a * a for an n limb operand, same layout and scratch size as limbsKaratsuba
+// z0 = low^2, z2 = high^2 and z1 = (low + high)^2 - z0 - z2 are all squares, so every level recurses on one operand only
+void limbsKaratsubaSqr (limb_t* r, const limb_t* a, short n, limb_t* scratch) {
+    if (n <= karatsubaThreshold) {
+        STATS_KARATSUBA_LEAF();
+        limbsSqr(r, a, n);
+        return;
     }
+    STATS_KARATSUBA_ENTER();
 
-    BigInt current;
-    initializeBigInt(&current, dividend.size, POSITIVE);
-    short current_size = 0;
-    
-    short quotient_pos = 0;
-    bool started = FALSE;
-    
-    for (short i = 0; i < dividend.size; i++) {
-        if (current_size > 0 || dividend.digit_array[i] > 0) {
-            current.digit_array[current_size++] = dividend.digit_array[i];
-            current.size = current_size;
-        }
-        
-        if (current_size > 0) {
-            uint8_t count = 0;
-            while (compareMagnitude(current, divisor) != SMALL) {
-                BigInt temp = subraction(current, divisor, current.size, POSITIVE);
-                free(current.digit_array);
-                current = temp;
-                count++;
-
-                short j = 0;
-                while (j < current.size - 1 && current.digit_array[j] == 0) {
-                    j++;
-                }
-                if (j > 0) {
-                    memmove(current.digit_array, current.digit_array + j, current.size - j);
-                    current_size = current.size - j;
-                    current.size = current_size;
-                }
-            }
-            
-            if (count > 0 || started) {
-                quotient.digit_array[quotient_pos++] = count;
-                started = TRUE;
-            }
-        }
-    }
+    short half = n / 2;
+    short high = n - half;
+    limb_t* x_sum = scratch;
+    limb_t* z1 = x_sum + 2 * (high + 1);
+    limb_t* next = z1 + 2 * (high + 1);
 
-    if (quotient_pos == 0) {
-        quotient.size = 1;
-        quotient.digit_array[0] = 0;
-    } else {
-        quotient.size = quotient_pos;
-    }
+    limbsKaratsubaSqr(r, a, half, next);
+    limbsKaratsubaSqr(r + 2 * half, a + half, high, next);
 
-    quotient.sign = (dividend.sign == divisor.sign) ? POSITIVE : NEGATIVE;
-    free(current.digit_array);
-    
-    return quotient;
+    x_sum[high] = limbsAdd(x_sum, a + half, high, a, half);
+    limbsKaratsubaSqr(z1, x_sum, high + 1, next);
+
+    limbsSub(z1, z1, 2 * (high + 1), r, 2 * half);
+    limbsSub(z1, z1, 2 * (high + 1), r + 2 * half, 2 * high);
+    limbsAdd(r + half, r + half, 2 * n - half, z1, 2 * (high + 1));
+    STATS_KARATSUBA_EXIT();
 }
 
-void printDigits(BigInt b) {
-    short size = b.size;
-    short i = 0;
+/*
+Multiplication tiers above Karatsuba
+--> limbsMultiply picks the algorithm by operand size: schoolbook up to karatsubaThreshold, Karatsuba up to toom3Threshold,
+    Toom-3 up to nttThreshold and the number theoretic transform above that, all thresholds can be set at runtime
+--> Toom-3 cuts both operands in three pieces, evaluates the two quadratics at 0, 1, -1, -2 and infinity, multiplies the
+    five values (recursively, through limbsMultiply) and interpolates back (Bodrato's sequence): 5 products of n / 3
+    limbs instead of 9, O(n^1.46)
+--> the NTT treats every limb as a coefficient and convolves the two limb arrays modulo two 62 bit primes of the form
+    c * 2^32 + 1, each coefficient of the product is below 2^64 * length, far below p1 * p2, so the Chinese remainder
+    theorem gives it back exactly, O(n log n)
+--> modular products use Montgomery reduction with R = 2^64, the twiddle factors are kept in Montgomery form, so the data
+    itself never has to be converted
+*/
+#ifndef TOOM3_THRESHOLD
+#define TOOM3_THRESHOLD 150 // default threshold (in limbs) for Toom-3, ./bigint --tune measures the real one
+#endif
+#ifndef NTT_THRESHOLD
+#define NTT_THRESHOLD 10000 // default threshold (in limbs) for the NTT multiply, ./bigint --tune measures the real one
+#endif
+#define TOOM3_MIN_THRESHOLD 12 // every piece must still be larger than the karatsuba minimum
 
-    //to make sure starting zeroes are not printed
-    while (i < size - 1 && b.digit_array[i] == 0) {
-        i = i + 1;
-    }
+short toom3Threshold = TOOM3_THRESHOLD;
+short nttThreshold = NTT_THRESHOLD;
 
-    if (isBigIntZero(b)) {
-        printf("0\n");
-        return;
+void setToom3Threshold (short threshold) {
+    toom3Threshold = max(threshold, TOOM3_MIN_THRESHOLD);
+}
+
+short getToom3Threshold () {
+    return toom3Threshold;
+}
+
+//a threshold above any possible operand size switches the NTT tier off
+void setNttThreshold (short threshold) {
+    nttThreshold = max(threshold, TOOM3_MIN_THRESHOLD);
+}
+
+short getNttThreshold () {
+    return nttThreshold;
+}
+
+//r = a << bits for 0 < bits < 32 over n limbs, r may be a, returns the bits shifted out of the top limb
+limb_t limbsShiftLeft (limb_t* r, const limb_t* a, short n, short bits) {
+    limb_t out = 0;
+    for (short i = 0; i < n; i++) {
+        limb_t limb = a[i];
+        r[i] = (limb << bits) | out;
+        out = limb >> (LIMB_BITS - bits);
+    }
+    return out;
+}
+
+//r = a >> bits for 0 < bits < 32 over n limbs, r may be a
+void limbsShiftRight (limb_t* r, const limb_t* a, short n, short bits) {
+    for (short i = 0; i < n; i++) {
+        limb_t next = (i + 1 < n) ? a[i + 1] : 0;
+        r[i] = (a[i] >> bits) | (next << (LIMB_BITS - bits));
+    }
+}
+
+void limbsMultiply (limb_t* r, const limb_t* a, short an, const limb_t* b, short bn, limb_t* scratch); //defined below, Toom-3 recurses through it
+int limbsMultiplyScratch (short n);
+
+//r = x * y with signs, r needs xn + yn limbs, returns the limbs used
+short toom3SignedProduct (limb_t* r, numSign* rSign, const limb_t* x, short xn, numSign xSign, const limb_t* y, short yn, numSign ySign, limb_t* scratch) {
+    xn = limbsUsed(x, xn);
+    yn = limbsUsed(y, yn);
+    if (xn == 0 || yn == 0) {
+        *rSign = POSITIVE;
+        return 0;
+    }
+    limbsMultiply(r, x, xn, y, yn, scratch);
+    *rSign = xSign ^ ySign;
+    return limbsUsed(r, xn + yn);
+}
+
+//evaluates a0 + a1 * x + a2 * x^2 at 1, -1 and -2 into v1, vm1 and vm2 (k + 3 limbs each), returns their sizes and signs
+void toom3Evaluate (limb_t* v1, short* n1, limb_t* vm1, short* nm1, numSign* sm1, limb_t* vm2, short* nm2, numSign* sm2,
+                    const limb_t* a, short k, short a2n) {
+    const limb_t* a0 = a;
+    const limb_t* a1 = a + k;
+    const limb_t* a2 = a + 2 * k;
+
+    //v1 = (a0 + a2) + a1 and vm1 = (a0 + a2) - a1, a0 + a2 is built in vm2 for a moment
+    vm2[k] = limbsAdd(vm2, a0, k, a2, a2n);
+    v1[k + 1] = limbsAdd(v1, vm2, k + 1, a1, k);
+    *n1 = limbsUsed(v1, k + 2);
+    *nm1 = limbsSignedAdd(vm1, sm1, vm2, k + 1, POSITIVE, a1, k, NEGATIVE);
+
+    //vm2 = 2 * (vm1 + a2) - a0
+    *nm2 = limbsSignedAdd(vm2, sm2, vm1, *nm1, *sm1, a2, a2n, POSITIVE);
+    vm2[*nm2] = limbsShiftLeft(vm2, vm2, *nm2, 1);
+    *nm2 = limbsSignedAdd(vm2, sm2, vm2, *nm2 + 1, *sm2, a0, k, NEGATIVE);
+}
+
+//limbs of scratch space limbsToom3 needs for two n limb operands
+int limbsToom3Scratch (short n) {
+    short k = (n + 2) / 3;
+    return 6 * (k + 3) + 4 * (2 * k + 7) + limbsMultiplyScratch(k + 2);
+}
+
+//Toom-3, r = a * b for two n limb operands, r needs 2 * n limbs and must not overlap a or b
+//scratch needs limbsToom3Scratch(n) limbs, the five products go back through limbsMultiply so they pick their own tier
+void limbsToom3 (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t* scratch) {
+    STATS_BEGIN();
+    short k = (n + 2) / 3; //a = a0 + a1 * B^k + a2 * B^2k, a2 has the remaining n - 2k limbs
+    short top = n - 2 * k;
+    short p = 2 * k + 7; //room for a product of two k + 3 limb values plus the carry of one signed add
+
+    limb_t* a1v = scratch;
+    limb_t* am1v = a1v + k + 3;
+    limb_t* am2v = am1v + k + 3;
+    limb_t* b1v = am2v + k + 3;
+    limb_t* bm1v = b1v + k + 3;
+    limb_t* bm2v = bm1v + k + 3;
+    limb_t* w1 = bm2v + k + 3;
+    limb_t* wm1 = w1 + p;
+    limb_t* wm2 = wm1 + p;
+    limb_t* t = wm2 + p;
+    limb_t* next = t + p;
+
+    short a1n, am1n, am2n, b1n, bm1n, bm2n;
+    numSign am1s, am2s, bm1s, bm2s;
+    toom3Evaluate(a1v, &a1n, am1v, &am1n, &am1s, am2v, &am2n, &am2s, a, k, top);
+    toom3Evaluate(b1v, &b1n, bm1v, &bm1n, &bm1s, bm2v, &bm2n, &bm2s, b, k, top);
+
+    //w0 = a0 * b0 and winf = a2 * b2 go straight into their final place in r
+    short w0n, winfn, w1n, wm1n, wm2n, tn;
+    numSign w0s, winfs, w1s, wm1s, wm2s, ts;
+    memset(r, 0, 2 * n * sizeof(limb_t));
+    w0n = toom3SignedProduct(r, &w0s, a, k, POSITIVE, b, k, POSITIVE, next);
+    winfn = toom3SignedProduct(r + 4 * k, &winfs, a + 2 * k, top, POSITIVE, b + 2 * k, top, POSITIVE, next);
+    w1n = toom3SignedProduct(w1, &w1s, a1v, a1n, POSITIVE, b1v, b1n, POSITIVE, next);
+    wm1n = toom3SignedProduct(wm1, &wm1s, am1v, am1n, am1s, bm1v, bm1n, bm1s, next);
+    wm2n = toom3SignedProduct(wm2, &wm2s, am2v, am2n, am2s, bm2v, bm2n, bm2s, next);
+    const limb_t* w0 = r;
+    const limb_t* winf = r + 4 * k;
+
+    //interpolation, every division is exact
+    //r3 = (wm2 - w1) / 3
+    wm2n = limbsSignedAdd(wm2, &wm2s, wm2, wm2n, wm2s, w1, w1n, w1s ^ NEGATIVE);
+    limbsDivSmall(wm2, wm2n, 3);
+    wm2n = limbsUsed(wm2, wm2n);
+    //r1 = (w1 - wm1) / 2
+    w1n = limbsSignedAdd(w1, &w1s, w1, w1n, w1s, wm1, wm1n, wm1s ^ NEGATIVE);
+    limbsShiftRight(w1, w1, w1n, 1);
+    w1n = limbsUsed(w1, w1n);
+    //r2 = wm1 - w0
+    wm1n = limbsSignedAdd(wm1, &wm1s, wm1, wm1n, wm1s, w0, w0n, NEGATIVE);
+    //r3 = (r2 - r3) / 2 + 2 * winf
+    tn = limbsSignedAdd(t, &ts, wm1, wm1n, wm1s, wm2, wm2n, wm2s ^ NEGATIVE);
+    limbsShiftRight(t, t, tn, 1);
+    tn = limbsUsed(t, tn);
+    wm2n = limbsSignedAdd(wm2, &wm2s, t, tn, ts, winf, winfn, POSITIVE);
+    wm2n = limbsSignedAdd(wm2, &wm2s, wm2, wm2n, wm2s, winf, winfn, POSITIVE);
+    //r2 = r2 + r1 - winf
+    wm1n = limbsSignedAdd(wm1, &wm1s, wm1, wm1n, wm1s, w1, w1n, w1s);
+    wm1n = limbsSignedAdd(wm1, &wm1s, wm1, wm1n, wm1s, winf, winfn, NEGATIVE);
+    //r1 = r1 - r3
+    w1n = limbsSignedAdd(w1, &w1s, w1, w1n, w1s, wm2, wm2n, wm2s ^ NEGATIVE);
+
+    //r1, r2 and r3 are coefficients of the product, so none of them is negative
+    limbsAdd(r + k, r + k, 2 * n - k, w1, w1n);
+    limbsAdd(r + 2 * k, r + 2 * k, 2 * n - 2 * k, wm1, wm1n);
+    limbsAdd(r + 3 * k, r + 3 * k, 2 * n - 3 * k, wm2, wm2n);
+    STATS_END(STAT_TOOM3);
+}
+
+#ifdef __SIZEOF_INT128__
+#define NTT_AVAILABLE
+typedef unsigned __int128 qlimb_t; //four limbs, for the 64 bit modular products and the CRT
+
+#define NTT_PRIME_1 0x3fffffee00000001ull //1073741806 * 2^32 + 1, primitive root 3
+#define NTT_PRIME_2 0x3fffffb400000001ull //1073741748 * 2^32 + 1, primitive root 19
+
+//one prime with its Montgomery constants
+typedef struct nttPrime {
+    uint64_t p;
+    uint64_t pNegInv; //-p^-1 mod 2^64
+    uint64_t r2; //2^128 mod p
+    uint64_t root; //primitive root
+}nttPrime;
+
+//Montgomery reduction of t < p * 2^64, returns t * 2^-64 mod p (below p)
+static inline uint64_t nttReduce (qlimb_t t, const nttPrime* q) {
+    uint64_t m = (uint64_t)t * q -> pNegInv;
+    uint64_t u = (uint64_t)((t + (qlimb_t)m * q -> p) >> 64);
+    return (u >= q -> p) ? u - q -> p : u;
+}
+
+static inline uint64_t nttMul (uint64_t a, uint64_t b, const nttPrime* q) {
+    return nttReduce((qlimb_t)a * b, q);
+}
+
+static inline uint64_t nttAdd (uint64_t a, uint64_t b, const nttPrime* q) {
+    uint64_t s = a + b; //both below 2^62, no overflow
+    return (s >= q -> p) ? s - q -> p : s;
+}
+
+static inline uint64_t nttSub (uint64_t a, uint64_t b, const nttPrime* q) {
+    return (a >= b) ? a - b : a + q -> p - b;
+}
+
+//plain (not Montgomery) power, only used a handful of times per multiply
+uint64_t nttPowPlain (uint64_t base, uint64_t e, uint64_t p) {
+    uint64_t result = 1;
+    base %= p;
+    while (e > 0) {
+        if (e & 1) {
+            result = (uint64_t)((qlimb_t)result * base % p);
+        }
+        base = (uint64_t)((qlimb_t)base * base % p);
+        e >>= 1;
+    }
+    return result;
+}
+
+void nttInitPrime (nttPrime* q, uint64_t p, uint64_t root) {
+    uint64_t inv = p; //Newton's iteration, every step doubles the correct low bits (p * p = 1 mod 8 to start)
+    for (short i = 0; i < 5; i++) {
+        inv *= 2 - p * inv;
+    }
+    q -> p = p;
+    q -> pNegInv = 0 - inv;
+    uint64_t r = (uint64_t)(((qlimb_t)1 << 64) % p);
+    q -> r2 = (uint64_t)((qlimb_t)r * r % p);
+    q -> root = root;
+}
+
+//forward transform (decimation in frequency), leaves the result in bit reversed order
+void nttForward (uint64_t* x, int length, const uint64_t* twiddle, const nttPrime* q) {
+    for (int half = length / 2, stride = 1; half >= 1; half /= 2, stride *= 2) {
+        for (int s = 0; s < length; s += 2 * half) {
+            for (int j = 0; j < half; j++) {
+                uint64_t u = x[s + j];
+                uint64_t v = x[s + j + half];
+                x[s + j] = nttAdd(u, v, q);
+                x[s + j + half] = nttMul(nttSub(u, v, q), twiddle[j * stride], q);
+            }
+        }
+    }
+}
+
+//inverse transform (decimation in time) from bit reversed order back to natural order, without the 1 / length scaling
+void nttInverse (uint64_t* x, int length, const uint64_t* twiddle, const nttPrime* q) {
+    for (int half = 1, stride = length / 2; half < length; half *= 2, stride /= 2) {
+        for (int s = 0; s < length; s += 2 * half) {
+            for (int j = 0; j < half; j++) {
+                uint64_t u = x[s + j];
+                uint64_t v = nttMul(x[s + j + half], twiddle[j * stride], q);
+                x[s + j] = nttAdd(u, v, q);
+                x[s + j + half] = nttSub(u, v, q);
+            }
+        }
+    }
+}
+
+//transform length for a product of an + bn limbs, the smallest power of two that holds every coefficient
+int nttLength (short an, short bn) {
+    int length = 1;
+    while (length < an + bn) {
+        length *= 2;
+    }
+    return length;
+}
+
+//limbs of scratch space limbsNttMultiply needs when the larger operand has n limbs
+//three uint64 arrays of the transform length and two half length twiddle tables, plus one limb to align them
+int limbsNttScratch (short n) {
+    return 2 * 4 * nttLength(n, n) + 1;
+}
+
+//convolution of a and b modulo one prime into x (length values, natural order), y is a second array of the same length
+void nttConvolve (uint64_t* x, uint64_t* y, uint64_t* twiddle, uint64_t* inverseTwiddle, int length,
+                  const limb_t* a, short an, const limb_t* b, short bn, const nttPrime* q) {
+    //twiddle[j] = w^j and inverseTwiddle[j] = w^-j in Montgomery form, w a primitive length-th root of unity
+    uint64_t w = nttPowPlain(q -> root, (q -> p - 1) / length, q -> p);
+    uint64_t wMont = nttMul(w, q -> r2, q);
+    uint64_t wInvMont = nttMul(nttPowPlain(w, length - 1, q -> p), q -> r2, q);
+    twiddle[0] = inverseTwiddle[0] = nttMul(1, q -> r2, q);
+    for (int j = 1; j < length / 2; j++) {
+        twiddle[j] = nttMul(twiddle[j - 1], wMont, q);
+        inverseTwiddle[j] = nttMul(inverseTwiddle[j - 1], wInvMont, q);
+    }
+
+    for (int i = 0; i < length; i++) {
+        x[i] = (i < an) ? a[i] : 0;
+    }
+    nttForward(x, length, twiddle, q);
+    if (a == b && an == bn) { //a square needs one forward transform
+        for (int i = 0; i < length; i++) {
+            x[i] = nttMul(x[i], x[i], q);
+        }
+    } else {
+        for (int i = 0; i < length; i++) {
+            y[i] = (i < bn) ? b[i] : 0;
+        }
+        nttForward(y, length, twiddle, q);
+        for (int i = 0; i < length; i++) {
+            x[i] = nttMul(x[i], y[i], q);
+        }
+    }
+    nttInverse(x, length, inverseTwiddle, q);
+
+    //the pointwise products left a factor 2^-64 and the inverse a factor length, scale by 2^64 / length:
+    //nttMul(x, c) = x * c * 2^-64 with c = length^-1 * 2^128 mod p
+    uint64_t scale = nttMul(nttMul(nttPowPlain(length, q -> p - 2, q -> p), q -> r2, q), q -> r2, q);
+    for (int i = 0; i < length; i++) {
+        x[i] = nttMul(x[i], scale, q);
+    }
+}
+
+//r = a * b with the number theoretic transform, r needs an + bn limbs and must not overlap a or b
+//scratch needs limbsNttScratch(max(an, bn)) limbs
+void limbsNttMultiply (limb_t* r, const limb_t* a, short an, const limb_t* b, short bn, limb_t* scratch) {
+    STATS_BEGIN();
+    int length = nttLength(an, bn);
+    uint64_t* first = (uint64_t*)(((uintptr_t)scratch + 7) & ~(uintptr_t)7);
+    uint64_t* second = first + length;
+    uint64_t* y = second + length;
+    uint64_t* twiddle = y + length;
+    uint64_t* inverseTwiddle = twiddle + length / 2;
+
+    nttPrime q1, q2;
+    nttInitPrime(&q1, NTT_PRIME_1, 3);
+    nttInitPrime(&q2, NTT_PRIME_2, 19);
+    nttConvolve(first, y, twiddle, inverseTwiddle, length, a, an, b, bn, &q1);
+    nttConvolve(second, y, twiddle, inverseTwiddle, length, a, an, b, bn, &q2);
+
+    //CRT: c = c1 + p1 * ((c2 - c1) * p1^-1 mod p2), then the carries of the coefficients run through the limbs
+    uint64_t p1InvMont = nttMul(nttPowPlain(NTT_PRIME_1 % NTT_PRIME_2, NTT_PRIME_2 - 2, NTT_PRIME_2), q2.r2, &q2);
+    qlimb_t carry = 0;
+    for (int i = 0; i < an + bn; i++) {
+        uint64_t c1 = first[i];
+        uint64_t t = nttMul(nttSub(second[i], c1 % NTT_PRIME_2, &q2), p1InvMont, &q2);
+        carry += (qlimb_t)c1 + (qlimb_t)NTT_PRIME_1 * t;
+        r[i] = (limb_t)carry;
+        carry >>= LIMB_BITS;
+    }
+    STATS_END(STAT_NTT);
+}
+#endif
+
+//limbs of scratch space karatsubaMultiplyWithScratch needs when the larger operand has n limbs
+//the two operands are zero padded to n limbs inside scratch, so that is included
+int karatsubaScratchSize (short n) {
+    return 2 * n + limbsKaratsubaScratch(n);
+}
+
+//karatsubaMultiply with caller supplied workspace of karatsubaScratchSize(max(x.size, y.size)) limbs
+//only the result is allocated, so a caller reusing one scratch buffer does a single allocation per multiply
+BigInt karatsubaMultiplyWithScratch(BigInt x, BigInt y, limb_t* scratch) {
+    short n = max(x.size, y.size);
+
+    if (n <= karatsubaThreshold) {
+        STATS_KARATSUBA_LEAF();
+        return multiplyTwoBigInt(x, y);
+    }
+    STATS_BEGIN();
+
+    BigInt result;
+    if (!checkLimbCount(2L * n)) {
+        STATS_END(STAT_MUL_KARATSUBA);
+        initializeBigInt(&result, 0, POSITIVE);
+        return result;
+    }
+    if (!initializeBigInt(&result, 2 * n, x.sign ^ y.sign)) {
+        STATS_END(STAT_MUL_KARATSUBA);
+        return result;
+    }
+
+    // operands of different length are zero padded to n limbs
+    limb_t* x_pad = scratch;
+    limb_t* y_pad = x_pad + n;
+    memcpy(x_pad, x.limb_array, x.size * sizeof(limb_t));
+    memset(x_pad + x.size, 0, (n - x.size) * sizeof(limb_t));
+    memcpy(y_pad, y.limb_array, y.size * sizeof(limb_t));
+    memset(y_pad + y.size, 0, (n - y.size) * sizeof(limb_t));
+
+    limbsKaratsuba(result.limb_array, x_pad, y_pad, n, y_pad + n);
+
+    trimBigInt(&result);
+    checkOverflow(result.size);
+    STATS_END(STAT_MUL_KARATSUBA);
+    return result;
+}
+
+BigInt karatsubaMultiply(BigInt x, BigInt y) {
+    short n = max(x.size, y.size);
+
+    // Base case: use naive multiplication for small numbers
+    if (n <= karatsubaThreshold) {
+        return multiplyTwoBigInt(x, y);
+    }
+
+    limb_t* scratch = (limb_t*) malloc(karatsubaScratchSize(n) * sizeof(limb_t));
+    if (scratch == NULL) {
+        BigInt zero = {NULL, POSITIVE, 0, 0};
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        return zero;
+    }
+    STATS_ALLOC(karatsubaScratchSize(n) * sizeof(limb_t));
+    BigInt result = karatsubaMultiplyWithScratch(x, y, scratch);
+    free(scratch);
+
+    return result;
+}
+
+/*
+Parallel multiply : setParallelMultiply(depth, cutoff)
+--> the three Karatsuba products z0 = low * low, z2 = high * high and z1 = (low + high) * (low + high) are independent,
+    so the top depth levels run them as tasks on their own threads, 3^depth tasks in all
+--> below cutoff limbs (or depth levels down) a task goes back to the serial dispatcher, so the leaves still pick
+    schoolbook, Karatsuba, Toom-3 or NTT by size
+--> every task gets its own region of the scratch block, sized up front by limbsMultiplyParallelScratch, so the
+    threads never share a temporary or call the allocator
+--> the calling thread runs z1 itself while two new threads run z0 and z2, if a thread cannot be started its task runs
+    on the calling thread after z1, so the answer never depends on how many threads there were
+--> off by default (depth 0), multiplyBigInt uses it for balanced operands of cutoff limbs and more
+*/
+#define PARALLEL_MULTIPLY_DEPTH 0 //levels split into threads, 0 keeps every multiply on the calling thread
+#define PARALLEL_MULTIPLY_CUTOFF 2048 //limbs below which a task stays serial, a thread start costs about a 200 limb multiply
+
+short parallelMultiplyDepth = PARALLEL_MULTIPLY_DEPTH;
+short parallelMultiplyCutoff = PARALLEL_MULTIPLY_CUTOFF;
+
+//depth 2 uses 9 threads, 3 uses 27, set it once at startup like the thresholds
+void setParallelMultiply (short depth, short cutoff) {
+    parallelMultiplyDepth = (depth > 0) ? depth : 0;
+    parallelMultiplyCutoff = max(cutoff, 2 * karatsubaThreshold); //both halves must still be worth a split
+}
+
+//limbs of scratch space limbsMultiplyParallel needs for two n limb operands split depth levels deep
+int limbsMultiplyParallelScratch (short n, short depth) {
+    if (depth == 0 || n < parallelMultiplyCutoff) {
+        return limbsMultiplyScratch(n);
+    }
+    short half = n / 2;
+    short high = n - half;
+    return 4 * (high + 1) + limbsMultiplyParallelScratch(half, depth - 1) + limbsMultiplyParallelScratch(high, depth - 1)
+           + limbsMultiplyParallelScratch(high + 1, depth - 1);
+}
+
+typedef struct multiplyTask {
+    limb_t* r;
+    const limb_t* a;
+    const limb_t* b;
+    limb_t* scratch;
+    short n;
+    short depth;
+} multiplyTask;
+
+void limbsMultiplyParallel (limb_t* r, const limb_t* a, const limb_t* b, short n, short depth, limb_t* scratch);
+
+void* multiplyTaskMain (void* arg) {
+    multiplyTask* task = (multiplyTask*) arg;
+    limbsMultiplyParallel(task -> r, task -> a, task -> b, task -> n, task -> depth, task -> scratch);
+    return NULL;
+}
+
+//r = a * b for two n limb operands with the top depth Karatsuba levels on separate threads
+//r needs 2 * n limbs and must not overlap a or b, scratch needs limbsMultiplyParallelScratch(n, depth) limbs
+void limbsMultiplyParallel (limb_t* r, const limb_t* a, const limb_t* b, short n, short depth, limb_t* scratch) {
+    if (depth == 0 || n < parallelMultiplyCutoff) {
+        limbsMultiply(r, a, n, b, n, scratch);
+        return;
+    }
+
+    //same split and layout as limbsKaratsuba, followed by one scratch region per task
+    short half = n / 2;
+    short high = n - half;
+    limb_t* x_sum = scratch;
+    limb_t* y_sum = x_sum + high + 1;
+    limb_t* z1 = y_sum + high + 1;
+    limb_t* lowScratch = z1 + 2 * (high + 1);
+    limb_t* highScratch = lowScratch + limbsMultiplyParallelScratch(half, depth - 1);
+    limb_t* sumScratch = highScratch + limbsMultiplyParallelScratch(high, depth - 1);
+
+    x_sum[high] = limbsAdd(x_sum, a + half, high, a, half);
+    y_sum[high] = limbsAdd(y_sum, b + half, high, b, half);
+
+    //z0 and z2 go straight into their halves of r, z1 into its own limbs
+    multiplyTask tasks[3] = {
+        {r, a, b, lowScratch, half, depth - 1},
+        {r + 2 * half, a + half, b + half, highScratch, high, depth - 1},
+        {z1, x_sum, y_sum, sumScratch, high + 1, depth - 1}
+    };
+    pthread_t handles[2];
+    bool started[2];
+    for (short t = 0; t < 2; t++) {
+        started[t] = (pthread_create(&handles[t], NULL, multiplyTaskMain, &tasks[t]) == 0) ? TRUE : FALSE;
+    }
+    multiplyTaskMain(&tasks[2]);
+    for (short t = 0; t < 2; t++) {
+        if (started[t]) {
+            pthread_join(handles[t], NULL);
+        } else {
+            multiplyTaskMain(&tasks[t]);
+        }
+    }
+
+    //z1 = z1 - z2 - z0, then r = z2 * BASE^(2 * half) + z1 * BASE^half + z0
+    limbsSub(z1, z1, 2 * (high + 1), r, 2 * half);
+    limbsSub(z1, z1, 2 * (high + 1), r + 2 * half, 2 * high);
+    limbsAdd(r + half, r + half, 2 * n - half, z1, 2 * (high + 1));
+}
+
+//x * y through the multiplication dispatcher, the tier (schoolbook, karatsuba, Toom-3, NTT) is picked by size
+//big balanced operands are split into threads when setParallelMultiply turned that on
+BigInt multiplyBigInt (BigInt x, BigInt y) {
+    STATS_BEGIN();
+    BigInt result;
+    short xn = x.size;
+    short yn = y.size;
+    short n = max(xn, yn);
+    short smaller = (xn < yn) ? xn : yn;
+    if (!checkLimbCount((long)xn + yn)) {
+        STATS_END(STAT_MUL);
+        initializeBigInt(&result, 0, POSITIVE);
+        return result;
+    }
+
+    //the split pads both operands to n limbs, so its product takes 2 * n limbs, more than xn + yn when they differ
+    if (parallelMultiplyDepth > 0 && smaller >= parallelMultiplyCutoff && 2 * smaller > n && 2L * n <= SHRT_MAX) {
+        //both are zero padded to n limbs inside the scratch block, the split needs equal lengths
+        if (initializeBigInt(&result, 2 * n, x.sign ^ y.sign)) {
+            int scratchSize = 2 * n + limbsMultiplyParallelScratch(n, parallelMultiplyDepth);
+            limb_t* scratch = (limb_t*) malloc(scratchSize * sizeof(limb_t));
+            if (scratch != NULL) {
+                STATS_ALLOC(scratchSize * sizeof(limb_t));
+                memcpy(scratch, x.limb_array, xn * sizeof(limb_t));
+                memset(scratch + xn, 0, (n - xn) * sizeof(limb_t));
+                memcpy(scratch + n, y.limb_array, yn * sizeof(limb_t));
+                memset(scratch + n + yn, 0, (n - yn) * sizeof(limb_t));
+                limbsMultiplyParallel(result.limb_array, scratch, scratch + n, n, parallelMultiplyDepth, scratch + 2 * n);
+                free(scratch);
+            } else {
+                raiseBigIntStatus(BIGINT_NO_MEMORY); //the result stays zero
+            }
+        }
+    } else if (initializeBigInt(&result, xn + yn, x.sign ^ y.sign) && xn > 0 && yn > 0) {
+        limb_t* scratch = (limb_t*) malloc((limbsMultiplyScratch(max(xn, yn)) + 1) * sizeof(limb_t));
+        if (scratch != NULL) {
+            STATS_ALLOC((limbsMultiplyScratch(max(xn, yn)) + 1) * sizeof(limb_t));
+            limbsMultiply(result.limb_array, x.limb_array, xn, y.limb_array, yn, scratch);
+            free(scratch);
+        } else {
+            raiseBigIntStatus(BIGINT_NO_MEMORY); //the result stays zero
+        }
+    }
+
+    trimBigInt(&result);
+    checkOverflow(result.size);
+    STATS_END(STAT_MUL);
+    return result;
+}
+
+//limbs of scratch space limbsMultiply needs when the larger operand has n limbs
+int limbsMultiplyScratch (short n) {
+    if (n <= karatsubaThreshold) {
+        return 0;
+    }
+    int size = 4 * n + ((n <= toom3Threshold) ? limbsKaratsubaScratch(n) : limbsToom3Scratch(n));
+#ifdef NTT_AVAILABLE
+    if (n > nttThreshold && limbsNttScratch(n) > size) {
+        size = limbsNttScratch(n);
+    }
+#endif
+    return size;
+}
+
+//r = a * b for operands of any length, r needs an + bn limbs and must not overlap a or b
+//the multiplication dispatcher: schoolbook, karatsuba, Toom-3 or NTT by size, never allocates,
+//scratch needs limbsMultiplyScratch(max(an, bn)) limbs
+void limbsMultiply (limb_t* r, const limb_t* a, short an, const limb_t* b, short bn, limb_t* scratch) {
+    if (an < bn) {
+        const limb_t* t = a;
+        a = b;
+        b = t;
+        short tn = an;
+        an = bn;
+        bn = tn;
+    }
+    short n = an;
+
+    //a short operand is not worth padding: schoolbook is an * bn limb multiplies against karatsuba on two an limb numbers
+    if (bn <= karatsubaThreshold) {
+        limbsMul(r, a, an, b, bn);
+        return;
+    }
+
+#ifdef NTT_AVAILABLE
+    //the transform does not care about the shapes of the operands, only about the length of the product
+    if (bn > nttThreshold) {
+        limbsNttMultiply(r, a, an, b, bn, scratch);
+        return;
+    }
+#endif
+
+    //very unbalanced: a is cut into bn limb blocks, each block times b is a balanced product added in at its offset
+    if (an >= 2 * bn) {
+        limb_t* block = scratch;
+        memset(r, 0, (an + bn) * sizeof(limb_t));
+        for (short i = 0; i < an; i += bn) {
+            short len = (an - i < bn) ? an - i : bn;
+            limbsMultiply(block, a + i, len, b, bn, block + 2 * bn);
+            limbsAdd(r + i, r + i, an + bn - i, block, len + bn);
+        }
+        return;
+    }
+
+    //both operands zero padded to n limbs, the 2n limb product is built in scratch and the used an + bn limbs copied out
+    limb_t* a_pad = scratch;
+    limb_t* b_pad = a_pad + n;
+    limb_t* product = b_pad + n;
+    memcpy(a_pad, a, an * sizeof(limb_t));
+    memset(a_pad + an, 0, (n - an) * sizeof(limb_t));
+    memcpy(b_pad, b, bn * sizeof(limb_t));
+    memset(b_pad + bn, 0, (n - bn) * sizeof(limb_t));
+
+    if (n <= toom3Threshold) {
+        limbsKaratsuba(product, a_pad, b_pad, n, product + 2 * n);
+    } else {
+        limbsToom3(product, a_pad, b_pad, n, product + 2 * n);
+    }
+    memcpy(r, product, (an + bn) * sizeof(limb_t));
+}
+
+//limbs of scratch space limbsSquare needs for an n limb operand
+int limbsSquareScratch (short n) {
+    return (n <= toom3Threshold) ? limbsKaratsubaScratch(n) : limbsMultiplyScratch(n);
+}
+
+//r = a * a, r needs 2 * n limbs and must not overlap a, scratch needs limbsSquareScratch(n) limbs
+//above the karatsuba range the square goes through the multiplication dispatcher (the NTT then transforms a only once)
+void limbsSquare (limb_t* r, const limb_t* a, short n, limb_t* scratch) {
+    if (n <= karatsubaThreshold) {
+        limbsSqr(r, a, n);
+    } else if (n <= toom3Threshold) {
+        limbsKaratsubaSqr(r, a, n, scratch);
+    } else {
+        limbsMultiply(r, a, n, a, n, scratch);
+    }
+}
+
+//x * x through the squaring kernels, about 1.5 times faster than karatsubaMultiply(x, x)
+BigInt squareBigInt(BigInt x) {
+    STATS_BEGIN();
+    BigInt result;
+    short n = x.size;
+
+    if (!checkLimbCount(2L * n)) {
+        STATS_END(STAT_SQUARE);
+        initializeBigInt(&result, 0, POSITIVE);
+        return result;
+    }
+    if (initializeBigInt(&result, 2 * n, POSITIVE)) {
+        limb_t* scratch = NULL;
+        if (n > karatsubaThreshold) {
+            scratch = (limb_t*) malloc(limbsSquareScratch(n) * sizeof(limb_t));
+            if (scratch != NULL) {
+                STATS_ALLOC(limbsSquareScratch(n) * sizeof(limb_t));
+            }
+        }
+        if (n <= karatsubaThreshold || scratch != NULL) {
+            limbsSquare(result.limb_array, x.limb_array, n, scratch);
+            free(scratch);
+        } else {
+            raiseBigIntStatus(BIGINT_NO_MEMORY); //the result stays zero
+        }
+    }
+
+    trimBigInt(&result);
+    checkOverflow(result.size);
+    STATS_END(STAT_SQUARE);
+    return result;
+}
+
+//quotient and remainder in one pass, the quotient is truncated towards zero and the remainder takes the dividend's sign
+//(same as / and % in C), so dividend = quotient * divisor + remainder
+void divmodBigInt(BigInt dividend, BigInt divisor, BigInt* quotient, BigInt* remainder) {
+    STATS_BEGIN();
+    if (isBigIntZero(divisor)) {
+        raiseBigIntStatus(BIGINT_DIVISION_BY_ZERO);
+        initializeBigInt(quotient, 0, POSITIVE);
+        initializeBigInt(remainder, 0, POSITIVE);
+        STATS_END(STAT_DIVMOD);
+        return;
+    }
+    bool allocated = initializeBigInt(quotient, dividend.size, (dividend.sign == divisor.sign) ? POSITIVE : NEGATIVE);
+    allocated = initializeBigInt(remainder, divisor.size, dividend.sign) && allocated;
+
+    limb_t* scratch = allocated ? (limb_t*) malloc(limbsDivRemScratch(dividend.size, divisor.size) * sizeof(limb_t)) : NULL;
+    if (scratch == NULL) {
+        //both come back as zero, still owning whatever limbs they got so freeBigInt works on them
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        quotient -> size = 0;
+        quotient -> sign = POSITIVE;
+        remainder -> size = 0;
+        remainder -> sign = POSITIVE;
+        STATS_END(STAT_DIVMOD);
+        return;
+    }
+    STATS_ALLOC(limbsDivRemScratch(dividend.size, divisor.size) * sizeof(limb_t));
+    remainder -> size = limbsDivRem(quotient -> limb_array, remainder -> limb_array, dividend.limb_array, dividend.size, divisor.limb_array, divisor.size, scratch);
+    free(scratch);
+
+    trimBigInt(quotient);
+    if (remainder -> size == 0) { //limbsDivRem already returned the used limbs, only the sign of a zero is left
+        remainder -> sign = POSITIVE;
+    }
+    STATS_END(STAT_DIVMOD);
+}
+
+BigInt divideBigInt(BigInt dividend, BigInt divisor) {
+    BigInt quotient, remainder;
+
+    divmodBigInt(dividend, divisor, &quotient, &remainder);
+    freeBigInt(&remainder);
+
+    return quotient;
+}
+
+BigInt modBigInt(BigInt dividend, BigInt divisor) {
+    BigInt quotient, remainder;
+
+    divmodBigInt(dividend, divisor, &quotient, &remainder);
+    freeBigInt(&quotient);
+
+    return remainder;
+}
+
+/*
+Output parameter api
+--> the _into functions write into a caller owned destination instead of returning a new BigInt, the destination's limbs
+    are reused whenever its capacity is big enough, so a loop like acc = acc + x * y stops allocating after warm up
+--> the destination may be one of the inputs (a = a + b): inputs are passed by value and keep pointing at the old limbs
+    when the destination has to grow, and the old limbs are freed only after the result is written
+--> a destination is any BigInt from initializeBigInt, or an empty one (BigInt r = {0}) that has no limbs yet
+--> temporaries come from a per thread workspace that grows on demand and is kept, freeWorkspace releases it
+*/
+__thread limb_t* threadWorkspace = NULL;
+__thread int threadWorkspaceSize = 0;
+
+//atleast limbs limbs of temporary space for the calling thread, the contents do not survive the next call
+limb_t* reserveWorkspace (int limbs) {
+    if (limbs < 1) { //always a real block, so NULL only ever means the allocation failed
+        limbs = 1;
+    }
+    if (limbs > threadWorkspaceSize) {
+        free(threadWorkspace);
+        threadWorkspace = (limb_t*) malloc(limbs * sizeof(limb_t));
+        if (threadWorkspace == NULL) {
+            threadWorkspaceSize = 0;
+            raiseBigIntStatus(BIGINT_NO_MEMORY);
+            return NULL;
+        }
+        STATS_ALLOC(limbs * sizeof(limb_t));
+        threadWorkspaceSize = limbs;
+    }
+    return threadWorkspace;
+}
+
+void freeWorkspace () {
+    free(threadWorkspace);
+    threadWorkspace = NULL;
+    threadWorkspaceSize = 0;
+}
+
+//grows b to hold atleast capacity limbs keeping its value, so later _into calls up to that size never allocate
+//returns FALSE (and leaves b as it was) when the limbs cannot be allocated
+bool reserveBigInt (BigInt* b, short capacity) {
+    if (b -> limb_array != NULL && capacity <= b -> capacity) {
+        return TRUE;
+    }
+    BigInt grown;
+    if (!initializeBigInt(&grown, capacity, b -> sign)) {
+        return FALSE;
+    }
+    if (b -> limb_array != NULL) {
+        memcpy(grown.limb_array, b -> limb_array, b -> size * sizeof(limb_t));
+    }
+    grown.size = b -> size;
+    free(b -> limb_array);
+    *b = grown;
+    return TRUE;
+}
+
+//gives r room for size limbs without keeping its value, *old receives the limbs it replaced (the caller frees them once
+//the inputs are no longer read) or NULL when the old limbs were big enough
+//returns FALSE (and leaves r as it was) when the limbs cannot be allocated
+bool replaceLimbs (BigInt* r, short size, limb_t** old) {
+    *old = NULL;
+    if (r -> limb_array != NULL && size <= r -> capacity) {
+        return TRUE;
+    }
+    BigInt grown;
+    if (!initializeBigInt(&grown, size, POSITIVE)) {
+        return FALSE;
+    }
+    *old = r -> limb_array;
+    *r = grown;
+    return TRUE;
+}
+
+//every _into function returns FALSE when it runs out of memory, the destination then keeps its old value
+bool copyBigIntInto (BigInt* r, BigInt a) {
+    if (r -> limb_array == a.limb_array) {
+        r -> size = a.size;
+        r -> sign = a.sign;
+        return TRUE;
+    }
+    limb_t* old;
+    if (!replaceLimbs(r, a.size, &old)) {
+        return FALSE;
+    }
+    memcpy(r -> limb_array, a.limb_array, a.size * sizeof(limb_t));
+    r -> size = a.size;
+    r -> sign = a.sign;
+    free(old);
+    return TRUE;
+}
+
+//*r = a + b, r may be a or b
+bool addBigIntInto (BigInt* r, BigInt a, BigInt b) {
+    STATS_BEGIN();
+    limb_t* old;
+    if (!replaceLimbs(r, max(a.size, b.size) + 1, &old)) { //extra limb for the carry out of the top limb
+        STATS_END(STAT_ADD);
+        return FALSE;
+    }
+    //the kernels go limb by limb at the same index, so r sharing limbs with a or b is fine
+    r -> size = limbsSignedAdd(r -> limb_array, &r -> sign, a.limb_array, a.size, a.sign, b.limb_array, b.size, b.sign);
+    free(old);
+
+    checkOverflow(r -> size);
+    STATS_END(STAT_ADD);
+    return TRUE;
+}
+
+//*r = a - b, r may be a or b
+bool subtractBigIntInto (BigInt* r, BigInt a, BigInt b) {
+    STATS_BEGIN();
+    b.sign = (b.sign == POSITIVE) ? NEGATIVE : POSITIVE; //b is our own copy, the caller's sign is untouched
+    bool done = addBigIntInto(r, a, b);
+    STATS_END(STAT_SUB);
+    return done;
+}
+
+//*r = a * b, r may be a or b
+bool multiplyBigIntInto (BigInt* r, BigInt a, BigInt b) {
+    STATS_BEGIN();
+    short an = a.size;
+    short bn = b.size;
+    if (!checkLimbCount((long)an + bn)) { //r keeps its old value, as on any other failure
+        STATS_END(STAT_MUL);
+        return FALSE;
+    }
+    short size = an + bn;
+    numSign sign = a.sign ^ b.sign;
+
+    //the product kernels must not write over their inputs, so a product into limbs shared with an input is built
+    //in the workspace first, the workspace is taken before r changes so a failure leaves r as it was
+    bool keepsLimbs = (r -> limb_array != NULL && size <= r -> capacity) ? TRUE : FALSE;
+    bool aliased = (keepsLimbs && (r -> limb_array == a.limb_array || r -> limb_array == b.limb_array)) ? TRUE : FALSE;
+    limb_t* work = reserveWorkspace((aliased ? size : 0) + limbsMultiplyScratch(max(an, bn)));
+    limb_t* old;
+    if (work == NULL || !replaceLimbs(r, size, &old)) {
+        STATS_END(STAT_MUL);
+        return FALSE;
+    }
+    limb_t* product = aliased ? work : r -> limb_array;
+
+    if (an > 0 && bn > 0) {
+        limbsMultiply(product, a.limb_array, an, b.limb_array, bn, aliased ? work + size : work);
+    }
+    if (aliased) {
+        memcpy(r -> limb_array, product, size * sizeof(limb_t));
+    }
+    r -> size = (an > 0 && bn > 0) ? limbsUsed(r -> limb_array, size) : 0;
+    r -> sign = (r -> size == 0) ? POSITIVE : sign;
+    free(old);
+
+    checkOverflow(r -> size);
+    STATS_END(STAT_MUL);
+    return TRUE;
+}
+
+//*q = a / b and *r = a % b with the same signs as divmodBigInt, q or r may be NULL when only one of them is wanted
+//q and r may be a or b, returns FALSE (and leaves q and r untouched) when b is zero or memory runs out
+bool divmodBigIntInto (BigInt* q, BigInt* r, BigInt a, BigInt b) {
+    STATS_BEGIN();
+    short an = a.size;
+    short dn = b.size;
+    if (dn == 0) {
+        raiseBigIntStatus(BIGINT_DIVISION_BY_ZERO);
+        STATS_END(STAT_DIVMOD);
+        return FALSE;
+    }
+
+    //both results are built in the workspace and copied out, so any destination may share limbs with the inputs
+    short qn = (an > 0) ? an : 1;
+    limb_t* work = reserveWorkspace(qn + dn + limbsDivRemScratch(qn, dn));
+    if (work == NULL) {
+        STATS_END(STAT_DIVMOD);
+        return FALSE;
+    }
+    limb_t* quotient = work;
+    limb_t* remainder = quotient + qn;
+    short remainderSize = 0;
+    if (an > 0) {
+        remainderSize = limbsDivRem(quotient, remainder, a.limb_array, an, b.limb_array, dn, remainder + dn);
+    } else {
+        quotient[0] = 0;
+    }
+
+    //both destinations are grown (keeping their values) before either is written, so running out of memory changes neither
+    short quotientSize = limbsUsed(quotient, qn);
+    if ((q != NULL && !reserveBigInt(q, quotientSize)) || (r != NULL && !reserveBigInt(r, remainderSize))) {
+        STATS_END(STAT_DIVMOD);
+        return FALSE;
+    }
+    if (q != NULL) {
+        memcpy(q -> limb_array, quotient, quotientSize * sizeof(limb_t));
+        q -> size = quotientSize;
+        q -> sign = (quotientSize == 0 || a.sign == b.sign) ? POSITIVE : NEGATIVE;
+    }
+    if (r != NULL) {
+        memcpy(r -> limb_array, remainder, remainderSize * sizeof(limb_t));
+        r -> size = remainderSize;
+        r -> sign = (remainderSize == 0) ? POSITIVE : a.sign;
+    }
+    STATS_END(STAT_DIVMOD);
+    return TRUE;
+}
+
+/*
+Fused multiply accumulate : addMulBigIntInto, subMulBigIntInto, addMulLimbBigIntInto, subMulLimbBigIntInto, dotBigIntInto
+--> acc += a * b without a product BigInt: when one operand is short (below the karatsuba threshold) the rows a * b[j]
+    are added straight into acc by limbsAddMul1 / limbsSubMul1, one pass over acc per limb of b and nothing else,
+    longer operands form the product in the workspace with limbsMultiply and add it in one pass
+--> the accumulator is worked on as a two's complement number over one limb more than the result can need, so a
+    product of the other sign is just subtracted, if acc changes sign the top limb wraps round and one negation at the
+    end turns it back into sign and magnitude
+--> the destination keeps its limbs while they are big enough, like the other _into functions, and may be a or b
+--> dotBigIntInto sums a[i] * b[i] in one workspace accumulator and writes the destination once at the end
+*/
+#define ADDMUL_EXTRA_LIMBS 2 //carry room over the longest product: one limb for the sum, one for the sign
+
+//r[0 .. n) += a * m, returns the limb carried out of the top
+limb_t limbsAddMul1 (limb_t* r, const limb_t* a, short n, limb_t m) {
+    dlimb_t carry = 0;
+
+    for (short i = 0; i < n; i++) {
+        dlimb_t cur = (dlimb_t)a[i] * m + r[i] + carry;
+        r[i] = (limb_t)cur;
+        carry = cur >> LIMB_BITS;
+    }
+
+    return (limb_t)carry;
+}
+
+//r[0 .. n) -= a * m, returns the limb borrowed from above the top
+limb_t limbsSubMul1 (limb_t* r, const limb_t* a, short n, limb_t m) {
+    dlimb_t borrow = 0;
+
+    for (short i = 0; i < n; i++) {
+        dlimb_t product = (dlimb_t)a[i] * m + borrow;
+        limb_t low = (limb_t)product;
+        borrow = (product >> LIMB_BITS) + (r[i] < low);
+        r[i] -= low;
+    }
+
+    return (limb_t)borrow;
+}
+
+//limbs of scratch space limbsAccumulateProduct needs for an an by bn limb product
+int limbsAccumulateScratch (short an, short bn) {
+    short shorter = (an < bn) ? an : bn;
+    return (shorter <= karatsubaThreshold) ? 0 : an + bn + limbsMultiplyScratch(max(an, bn));
+}
+
+//acc = acc +- a * b modulo BASE^size (two's complement), size must be atleast an + bn, acc must not overlap a or b
+void limbsAccumulateProduct (limb_t* acc, short size, const limb_t* a, short an, const limb_t* b, short bn, bool subtract, limb_t* scratch) {
+    if (an < bn) { //the rows run over the longer operand
+        const limb_t* t = a;
+        a = b;
+        b = t;
+        short tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn == 0) {
+        return;
+    }
+
+    if (bn > karatsubaThreshold) {
+        limb_t* product = scratch;
+        limbsMultiply(product, a, an, b, bn, product + an + bn);
+        if (subtract) {
+            limbsSub(acc, acc, size, product, an + bn);
+        } else {
+            limbsAdd(acc, acc, size, product, an + bn);
+        }
+        return;
+    }
+
+    for (short j = 0; j < bn; j++) {
+        limb_t carry = subtract ? limbsSubMul1(acc + j, a, an, b[j]) : limbsAddMul1(acc + j, a, an, b[j]);
+        //the carry or borrow of a row usually dies within a limb or two, so it is walked up only as far as it goes
+        for (short i = j + an; carry != 0 && i < size; i++) {
+            limb_t before = acc[i];
+            acc[i] = subtract ? before - carry : before + carry;
+            carry = subtract ? (before < carry) : (acc[i] < carry);
+        }
+    }
+}
+
+//turns acc (size limbs, two's complement) into its magnitude, returns TRUE when it was negative
+bool limbsTakeMagnitude (limb_t* acc, short size) {
+    if ((acc[size - 1] >> (LIMB_BITS - 1)) == 0) {
+        return FALSE;
+    }
+    limb_t carry = 1;
+    for (short i = 0; i < size; i++) {
+        acc[i] = ~acc[i] + carry;
+        carry = (carry && acc[i] == 0) ? 1 : 0;
+    }
+    return TRUE;
+}
+
+//*r = *r + a * b (subtract FALSE) or *r - a * b (subtract TRUE), b given as limbs so a single limb multiplier fits too
+bool addMulLimbsInto (BigInt* r, BigInt a, const limb_t* b, short bn, numSign bSign, bool subtract) {
+    STATS_BEGIN();
+    short an = a.size;
+    bn = limbsUsed(b, bn);
+    short rn = (r -> limb_array == NULL) ? 0 : r -> size;
+    if (an == 0 || bn == 0) {
+        STATS_END(STAT_ADDMUL);
+        return TRUE;
+    }
+    numSign productSign = a.sign ^ bSign ^ (subtract ? NEGATIVE : POSITIVE);
+    if (!checkLimbCount(((rn > an + bn) ? rn : an + bn) + (long)ADDMUL_EXTRA_LIMBS)) {
+        STATS_END(STAT_ADDMUL);
+        return FALSE;
+    }
+    short size = max(rn, an + bn) + ADDMUL_EXTRA_LIMBS;
+
+    //an input that shares limbs with r is copied into the workspace first, growing r may free those limbs
+    bool aliasA = (r -> limb_array != NULL && r -> limb_array == a.limb_array) ? TRUE : FALSE;
+    bool aliasB = (r -> limb_array != NULL && r -> limb_array == b) ? TRUE : FALSE;
+    int copied = (aliasA ? an : 0) + (aliasB ? bn : 0);
+    limb_t* work = reserveWorkspace(copied + limbsAccumulateScratch(an, bn));
+    if (work == NULL) {
+        STATS_END(STAT_ADDMUL);
+        return FALSE;
+    }
+    limb_t* scratch = work + copied;
+    if (aliasA) {
+        memcpy(work, a.limb_array, an * sizeof(limb_t));
+        a.limb_array = work;
+    }
+    if (aliasB) {
+        memcpy(work + (aliasA ? an : 0), b, bn * sizeof(limb_t));
+        b = work + (aliasA ? an : 0);
+    }
+    if (!reserveBigInt(r, size)) {
+        STATS_END(STAT_ADDMUL);
+        return FALSE;
+    }
+    memset(r -> limb_array + rn, 0, (size - rn) * sizeof(limb_t));
+    if (rn == 0) {
+        r -> sign = productSign;
+    }
+
+    limbsAccumulateProduct(r -> limb_array, size, a.limb_array, an, b, bn, (r -> sign != productSign) ? TRUE : FALSE, scratch);
+    if (limbsTakeMagnitude(r -> limb_array, size)) {
+        r -> sign = (r -> sign == POSITIVE) ? NEGATIVE : POSITIVE;
+    }
+    r -> size = limbsUsed(r -> limb_array, size);
+    if (r -> size == 0) {
+        r -> sign = POSITIVE;
+    }
+
+    checkOverflow(r -> size);
+    STATS_END(STAT_ADDMUL);
+    return TRUE;
+}
+
+//*r = *r + a * b, r may be a or b
+bool addMulBigIntInto (BigInt* r, BigInt a, BigInt b) {
+    return addMulLimbsInto(r, a, b.limb_array, b.size, b.sign, FALSE);
+}
+
+//*r = *r - a * b, r may be a or b
+bool subMulBigIntInto (BigInt* r, BigInt a, BigInt b) {
+    return addMulLimbsInto(r, a, b.limb_array, b.size, b.sign, TRUE);
+}
+
+//*r = *r + a * m for a single limb m, r may be a
+bool addMulLimbBigIntInto (BigInt* r, BigInt a, limb_t m) {
+    return addMulLimbsInto(r, a, &m, 1, POSITIVE, FALSE);
+}
+
+//*r = *r - a * m for a single limb m, r may be a
+bool subMulLimbBigIntInto (BigInt* r, BigInt a, limb_t m) {
+    return addMulLimbsInto(r, a, &m, 1, POSITIVE, TRUE);
+}
+
+//*r = a[0] * b[0] + ... + a[count - 1] * b[count - 1], r may be any of the inputs
+bool dotBigIntInto (BigInt* r, const BigInt* a, const BigInt* b, int count) {
+    STATS_BEGIN();
+    //the sum of count products below BASE^p stays below count * BASE^p, one limb over p covers any int count
+    int longest = 0;
+    int scratchSize = 0;
+    for (int i = 0; i < count; i++) {
+        short an = a[i].size;
+        short bn = b[i].size;
+        if (longest < an + bn) {
+            longest = an + bn;
+        }
+        if (scratchSize < limbsAccumulateScratch(an, bn)) {
+            scratchSize = limbsAccumulateScratch(an, bn);
+        }
+    }
+    if (!checkLimbCount(longest + (long)ADDMUL_EXTRA_LIMBS)) {
+        STATS_END(STAT_ADDMUL);
+        return FALSE;
+    }
+    short size = longest + ADDMUL_EXTRA_LIMBS;
+
+    limb_t* acc = reserveWorkspace(size + scratchSize);
+    if (acc == NULL) {
+        STATS_END(STAT_ADDMUL);
+        return FALSE;
+    }
+    memset(acc, 0, size * sizeof(limb_t));
+    for (int i = 0; i < count; i++) {
+        bool subtract = (a[i].sign != b[i].sign) ? TRUE : FALSE;
+        limbsAccumulateProduct(acc, size, a[i].limb_array, a[i].size, b[i].limb_array, b[i].size, subtract, acc + size);
+    }
+    numSign sign = limbsTakeMagnitude(acc, size) ? NEGATIVE : POSITIVE;
+    short used = limbsUsed(acc, size);
+
+    //the inputs are no longer read, so r can be replaced freely now
+    limb_t* old;
+    if (!replaceLimbs(r, used, &old)) {
+        STATS_END(STAT_ADDMUL);
+        return FALSE;
+    }
+    memcpy(r -> limb_array, acc, used * sizeof(limb_t));
+    r -> size = used;
+    r -> sign = (used == 0) ? POSITIVE : sign;
+    free(old);
+
+    checkOverflow(r -> size);
+    STATS_END(STAT_ADDMUL);
+    return TRUE;
+}
+
+/*
+Deferred carry accumulator : initAccumulator, accumulateBigInt, accumulatorValueInto
+--> every limb of the running sum gets a 64 bit lane, an addend is added lane by lane with no carry between lanes,
+    no comparison and no allocation once the lanes are wide enough, so the loop is one vectorisable pass per addend
+--> positive and negative addends go into separate lanes, the sign of an addend only picks the array
+--> a lane starts below BASE and takes less than BASE per addend, so ACCUMULATOR_MAX_PENDING addends can never
+    overflow it, after that many the lanes are normalized (carries moved up, every lane below BASE again)
+--> accumulatorValueInto normalizes both sums and writes positive - negative into a destination like the _into
+    functions do, the accumulator keeps its value and can take more addends afterwards
+*/
+#define ACCUMULATOR_MAX_PENDING 0xFFFFFFFFL //addends between normalizations, (BASE - 1) * BASE + BASE - 1 < 2^64
+#define ACCUMULATOR_MIN_LANES 8
+
+typedef struct bigIntAccumulator {
+    dlimb_t* positive; //lanes, capacity each, the value is the sum of positive[i] * BASE^i
+    dlimb_t* negative;
+    short capacity;
+    short used; //lanes past this are zero in both arrays
+    long pending; //addends since the last normalization
+} bigIntAccumulator;
+
+//an empty accumulator with room for limbs limb addends before it has to grow, FALSE when it can not be allocated
+bool initAccumulator (bigIntAccumulator* acc, short limbs) {
+    short capacity = max(limbs + 1, ACCUMULATOR_MIN_LANES); //one lane over the widest addend for the normalized carry
+    dlimb_t* block = (dlimb_t*) calloc(2 * capacity, sizeof(dlimb_t));
+    if (block == NULL) {
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        *acc = (bigIntAccumulator){NULL, NULL, 0, 0, 0};
+        return FALSE;
+    }
+    STATS_ALLOC(2 * capacity * sizeof(dlimb_t));
+    *acc = (bigIntAccumulator){block, block + capacity, capacity, 0, 0};
+    return TRUE;
+}
+
+void freeAccumulator (bigIntAccumulator* acc) {
+    free(acc -> positive);
+    *acc = (bigIntAccumulator){NULL, NULL, 0, 0, 0};
+}
+
+//back to zero, keeping the lanes
+void clearAccumulator (bigIntAccumulator* acc) {
+    memset(acc -> positive, 0, 2 * acc -> capacity * sizeof(dlimb_t));
+    acc -> used = 0;
+    acc -> pending = 0;
+}
+
+//moves the carries of lanes up, every lane ends below BASE, the top lane may grow used by one
+void normalizeLanes (dlimb_t* lanes, short used) {
+    dlimb_t carry = 0;
+    for (short i = 0; i <= used; i++) {
+        dlimb_t lane = lanes[i] + carry;
+        lanes[i] = (limb_t)lane;
+        carry = lane >> LIMB_BITS;
+    }
+}
+
+void normalizeAccumulator (bigIntAccumulator* acc) {
+    normalizeLanes(acc -> positive, acc -> used);
+    normalizeLanes(acc -> negative, acc -> used);
+    if (acc -> positive[acc -> used] != 0 || acc -> negative[acc -> used] != 0) {
+        acc -> used += 1;
+    }
+    acc -> pending = 0;
+}
+
+//grows the lanes to capacity, keeping both sums, FALSE (accumulator untouched) when memory runs out
+bool growAccumulator (bigIntAccumulator* acc, short capacity) {
+    dlimb_t* block = (dlimb_t*) calloc(2 * capacity, sizeof(dlimb_t));
+    if (block == NULL) {
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        return FALSE;
+    }
+    STATS_ALLOC(2 * capacity * sizeof(dlimb_t));
+    memcpy(block, acc -> positive, acc -> capacity * sizeof(dlimb_t));
+    memcpy(block + capacity, acc -> negative, acc -> capacity * sizeof(dlimb_t));
+    free(acc -> positive);
+    acc -> positive = block;
+    acc -> negative = block + capacity;
+    acc -> capacity = capacity;
+    return TRUE;
+}
+
+//acc = acc + x with no carry propagation, FALSE (x not added) when the lanes had to grow and could not
+bool accumulateBigInt (bigIntAccumulator* acc, BigInt x) {
+    short n = x.size;
+    //one lane to spare, normalizing carries into the lane above the highest one in use
+    short needed = max(n, acc -> used) + 2;
+    if (needed > acc -> capacity && !growAccumulator(acc, max(2 * acc -> capacity, needed))) {
+        return FALSE;
+    }
+    if (acc -> pending == ACCUMULATOR_MAX_PENDING) {
+        normalizeAccumulator(acc);
+    }
+
+    dlimb_t* lanes = (x.sign == NEGATIVE) ? acc -> negative : acc -> positive;
+    for (short i = 0; i < n; i++) {
+        lanes[i] += x.limb_array[i];
+    }
+    if (n > acc -> used) {
+        acc -> used = n;
+    }
+    acc -> pending += 1;
+    return TRUE;
+}
+
+//*r = the sum of every addend so far, FALSE (r keeps its old value) when memory runs out
+bool accumulatorValueInto (BigInt* r, bigIntAccumulator* acc) {
+    STATS_BEGIN();
+    normalizeAccumulator(acc);
+    short n = acc -> used;
+
+    //both sums packed down to limbs in the workspace, then one subtraction
+    limb_t* work = reserveWorkspace(2 * n);
+    limb_t* old;
+    if (work == NULL || !replaceLimbs(r, n + 1, &old)) {
+        STATS_END(STAT_ADD);
+        return FALSE;
+    }
+    limb_t* positive = work;
+    limb_t* negative = work + n;
+    for (short i = 0; i < n; i++) {
+        positive[i] = (limb_t)acc -> positive[i];
+        negative[i] = (limb_t)acc -> negative[i];
+    }
+    r -> size = limbsSignedAdd(r -> limb_array, &r -> sign, positive, n, POSITIVE, negative, n, NEGATIVE);
+    free(old);
+
+    checkOverflow(r -> size);
+    STATS_END(STAT_ADD);
+    return TRUE;
+}
+
+/*
+Decimal conversion by divide and conquer
+--> the table holds P(k) = 10^(9 * 2^k) for k = 0, 1, 2, ..., each one the square of the previous, built lazily and kept
+--> parsing splits the digit string so the low part has exactly 9 * 2^k digits: value = high * P(k) + low,
+    both halves are converted recursively and joined with one (karatsuba) multiply
+--> printing splits the limbs the same way: x = q * P(k) + r, r is printed padded to exactly 9 * 2^k digits
+--> every P(k) also keeps its Barrett reciprocal floor(BASE^(2m) / P(k)) (m = limbs of P(k)), so the split is
+    two multiplies instead of a long division (Handbook of Applied Cryptography 14.42)
+--> below DEC_SPLIT_LIMBS / DEC_SPLIT_DIGITS the plain 9 digits at a time loops are faster and are used instead
+--> P(k) stops at the largest level whose reciprocal still fits a short limb count, numbers above twice its size are
+    split at that level with one long division instead, the high part then is simply longer than the low part
+*/
+#define DEC_POWER_LEVELS 15 //P(14) is about 15300 limbs, the reciprocal of P(15) would need 2 * 30600 + 1 limbs
+#define DEC_SPLIT_LIMBS 64 //numbers up to this many limbs are printed with limbsDivSmall, measured crossover
+#define DEC_SPLIT_DIGITS 1440 //digit strings up to this length (about 150 limbs) are parsed with limbsMulSmallAdd
+#define DEC_LOCAL_SCRATCH 1024 //limbs of stack scratch fprintLimbs tries before it allocates
+#define DEC_MAX_DIGITS 315644 //digits of 2^(32 * SHRT_MAX) - 1, no longer decimal string fits a short limb count
+
+typedef struct decimalPower {
+    limb_t* power; //10^(9 * 2^k)
+    limb_t* reciprocal; //floor(BASE^(2 * size) / power), size + 1 limbs
+    short size; //limbs of power
+}decimalPower;
+
+decimalPower decimalPowers[DEC_POWER_LEVELS];
+short decimalPowerCount = 0; //levels built so far, a built level never changes again, published with release stores
+pthread_mutex_t decimalPowersLock = PTHREAD_MUTEX_INITIALIZER;
+
+//number of decimal digits P(level) stands for
+int decimalPowerDigits (short level) {
+    return DEC_CHUNK_DIGITS << level;
+}
+
+//builds P(0) .. P(level), callers on any thread may ask, the lock makes sure every level is built once
+//returns FALSE when memory runs out, the levels built before that stay usable
+//levels already there are found without the lock: the acquire load pairs with the release store of the count,
+//so a thread that sees the count also sees the limbs of every level below it
+bool buildDecimalPowers (short level) {
+    if (__atomic_load_n(&decimalPowerCount, __ATOMIC_ACQUIRE) > level) {
+        return TRUE;
+    }
+    pthread_mutex_lock(&decimalPowersLock);
+    while (decimalPowerCount <= level) {
+        short k = decimalPowerCount;
+        int size = (k == 0) ? 1 : 2 * decimalPowers[k - 1].size; //int, 2 * size + 1 is past a short at the top level
+        limb_t* block = (limb_t*) malloc((2 * size + 1) * sizeof(limb_t));
+        //numerator, quotient, remainder and division workspace for the reciprocal, the squaring uses the same space first
+        int scratchSize = 2 * (2 * size + 1) + size + limbsDivRemScratch(2 * size + 1, size);
+        if (k > 0 && scratchSize < limbsSquareScratch(decimalPowers[k - 1].size)) {
+            scratchSize = limbsSquareScratch(decimalPowers[k - 1].size);
+        }
+        limb_t* scratch = (limb_t*) malloc(scratchSize * sizeof(limb_t));
+        if (block == NULL || scratch == NULL) {
+            free(block);
+            free(scratch);
+            pthread_mutex_unlock(&decimalPowersLock);
+            return FALSE;
+        }
+        STATS_ALLOC((2 * size + 1 + scratchSize) * sizeof(limb_t));
+
+        if (k == 0) {
+            block[0] = DEC_CHUNK;
+        } else {
+            limbsSquare(block, decimalPowers[k - 1].power, decimalPowers[k - 1].size, scratch);
+            size = limbsUsed(block, size);
+        }
+
+        //reciprocal = BASE^(2 * size) / power, always exactly size + 1 limbs because power < BASE^size
+        limb_t* numerator = scratch;
+        limb_t* quotient = numerator + 2 * size + 1;
+        limb_t* remainder = quotient + 2 * size + 1;
+        memset(numerator, 0, 2 * size * sizeof(limb_t));
+        numerator[2 * size] = 1;
+        limbsDivRem(quotient, remainder, numerator, 2 * size + 1, block, size, remainder + size);
+
+        decimalPowers[k].power = block;
+        decimalPowers[k].reciprocal = block + size;
+        decimalPowers[k].size = size;
+        memcpy(decimalPowers[k].reciprocal, quotient, (size + 1) * sizeof(limb_t));
+        free(scratch);
+
+        __atomic_store_n(&decimalPowerCount, k + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&decimalPowersLock);
+    return TRUE;
+}
+
+//largest level whose P(k) has fewer than n limbs, so an n limb number is split into a quotient and a remainder
+//-1 when the powers could not be built
+short decimalPowerForLimbs (short n) {
+    short level = 0;
+    if (!buildDecimalPowers(0)) {
+        return -1;
+    }
+    while (level + 1 < DEC_POWER_LEVELS) {
+        if (!buildDecimalPowers(level + 1)) {
+            return -1;
+        }
+        if (decimalPowers[level + 1].size >= n) {
+            break;
+        }
+        level += 1;
+    }
+    return level;
+}
+
+//largest level with fewer than length digits, so the high part of the split is never longer than the low part
+//-1 when the powers could not be built
+short decimalPowerForDigits (int length) {
+    short level = 0;
+    while (level + 1 < DEC_POWER_LEVELS && decimalPowerDigits(level + 1) < length) {
+        level += 1;
+    }
+    return buildDecimalPowers(level) ? level : -1;
+}
+
+//converts the first length decimal digits (no sign character) into a, 9 digits at a time, returns the number of limbs used
+//a needs room for (length / 9 + 1) limbs, because 10^9 < 2^32 every 9 decimal digits need atmost one limb
+short limbsFromDecimalChunks (limb_t* a, const char *digits, int length) {
+    short used = 0;
+    int i = 0;
+
+    //digits are folded in 9 at a time: a = a * 10^k + chunk
+    while (i < length) {
+        limb_t chunk = 0, scale = 1;
+        short k = 0;
+        while (k < DEC_CHUNK_DIGITS && i < length) {
+            chunk = chunk * 10 + (limb_t)(digits[i] - '0');
+            scale *= 10;
+            i += 1;
+            k += 1;
+        }
+        limb_t carry = limbsMulSmallAdd(a, used, scale, chunk);
+        if (carry != 0) {
+            a[used] = carry;
+            used += 1;
+        }
+    }
+    return used;
+}
+
+//limbs of scratch space limbsFromDecimalSplit needs for a length digit string, -1 when the powers could not be built
+//once this succeeded every power the split asks for is built, so the split itself can not fail
+int limbsFromDecimalScratch (int length) {
+    if (length <= DEC_SPLIT_DIGITS) {
+        return 0;
+    }
+    short level = decimalPowerForDigits(length);
+    if (level < 0) {
+        return -1;
+    }
+    int lowDigits = decimalPowerDigits(level);
+    short highLimbs = (length - lowDigits) / DEC_CHUNK_DIGITS + 1;
+    short lowLimbs = lowDigits / DEC_CHUNK_DIGITS + 1;
+    short m = decimalPowers[level].size;
+
+    int join = highLimbs + m + limbsMultiplyScratch(max(highLimbs, m));
+    int high = limbsFromDecimalScratch(length - lowDigits), low = limbsFromDecimalScratch(lowDigits);
+    if (high < 0 || low < 0) {
+        return -1;
+    }
+    int children = (high > low) ? high : low;
+    return highLimbs + lowLimbs + ((join > children) ? join : children);
+}
+
+//converts length decimal digits into a by splitting them at a power of ten, returns the number of limbs used
+//a needs room for (length / 9 + 1) limbs, scratch needs limbsFromDecimalScratch(length) limbs
+short limbsFromDecimalSplit (limb_t* a, const char *digits, int length, limb_t* scratch) {
+    if (length <= DEC_SPLIT_DIGITS) {
+        return limbsFromDecimalChunks(a, digits, length);
+    }
+    short level = decimalPowerForDigits(length);
+    int lowDigits = decimalPowerDigits(level);
+    short m = decimalPowers[level].size;
+
+    limb_t* high = scratch;
+    limb_t* low = high + (length - lowDigits) / DEC_CHUNK_DIGITS + 1;
+    limb_t* rest = low + lowDigits / DEC_CHUNK_DIGITS + 1;
+    short highSize = limbsFromDecimalSplit(high, digits, length - lowDigits, rest);
+    short lowSize = limbsFromDecimalSplit(low, digits + length - lowDigits, lowDigits, rest);
+
+    //a = high * P(level) + low, low < P(level) so it has atmost m limbs and the sum never carries out of the product
+    limb_t* product = rest;
+    short size = (highSize + m > SHRT_MAX) ? SHRT_MAX : highSize + m; //the value fits a short, so a limb past it is zero
+    if (highSize == 0) {
+        memset(product, 0, m * sizeof(limb_t));
+    } else {
+        limbsMultiply(product, high, highSize, decimalPowers[level].power, m, product + size);
+    }
+    limbsAdd(product, product, size, low, lowSize);
+
+    size = limbsUsed(product, size);
+    memcpy(a, product, size * sizeof(limb_t));
+    return size;
+}
+
+//limbs a length digit number can need: ceil(length * log2(10) / 32), the constant is log2(10) / 32 rounded up
+//DEC_MAX_DIGITS digits can need SHRT_MAX + 1 limbs, readDecimalDigits folds the last of them in on its own
+long limbsForDecimalDigits (long length) {
+    return length * 103810253L / 1000000000L + 1;
+}
+
+//converts the first length decimal digits (no sign character) into a, returns the number of limbs used
+//a needs room for limbsForDecimalDigits(length) limbs, long strings allocate their own scratch for the split
+//without memory for the split it falls back to the 9 digit loop, slower but the same answer
+short limbsFromDecimalDigits (limb_t* a, const char *digits, int length) {
+    if (length <= DEC_SPLIT_DIGITS) {
+        return limbsFromDecimalChunks(a, digits, length);
+    }
+
+    int scratchSize = limbsFromDecimalScratch(length);
+    limb_t* scratch = (scratchSize < 0) ? NULL : (limb_t*) malloc(scratchSize * sizeof(limb_t));
+    if (scratch == NULL) {
+        return limbsFromDecimalChunks(a, digits, length);
+    }
+    STATS_ALLOC(scratchSize * sizeof(limb_t));
+    short used = limbsFromDecimalSplit(a, digits, length, scratch);
+    free(scratch);
+    return used;
+}
+
+//limbsFromDecimalDigits on the whole digits string
+short limbsFromDecimal (limb_t* a, char *digits) {
+    return limbsFromDecimalDigits(a, digits, strlen(digits));
+}
+
+//parses length decimal digits (no sign character) into b, returns FALSE with nothing allocated when the value
+//needs more than SHRT_MAX limbs (BIGINT_OVERFLOW) or b can not be allocated (BIGINT_NO_MEMORY)
+//the digits before the last one of a DEC_MAX_DIGITS string always fit, the last digit then must not carry past SHRT_MAX
+bool readDecimalDigits (BigInt* b, const char *digits, int length, numSign sign) {
+    if (length > DEC_MAX_DIGITS) {
+        raiseBigIntStatus(BIGINT_OVERFLOW);
+        return FALSE;
+    }
+    int head = (length == DEC_MAX_DIGITS) ? length - 1 : length;
+    short limbs = limbsForDecimalDigits(head);
+    if (!initializeBigInt(b, limbs, sign)) {
+        return FALSE;
+    }
+    b -> size = limbsFromDecimalDigits(b -> limb_array, digits, head);
+    if (head < length) {
+        limb_t carry = limbsMulSmallAdd(b -> limb_array, b -> size, 10, (limb_t)(digits[head] - '0'));
+        if (carry != 0 && b -> size == limbs) {
+            raiseBigIntStatus(BIGINT_OVERFLOW);
+            freeBigInt(b);
+            return FALSE;
+        }
+        if (carry != 0) {
+            b -> limb_array[b -> size++] = carry;
+        }
+    }
+    trimBigInt(b); //"-0" is zero with a positive sign
+    return TRUE;
+}
+
+BigInt readNumFromString (char *str) {
+    BigInt b;
+    STATS_BEGIN();
+    if (!readDecimalDigits(&b, str + 1, string_length(str), signSpecifier(str))) { //first character is the sign
+        initializeBigInt(&b, 0, POSITIVE); //too many digits for a short limb count, BIGINT_OVERFLOW and zero
+    }
+    STATS_END(STAT_PARSE);
+    return b;
+}
+
+//limbs of scratch space limbsToDecimalSplit needs for an n limb number, -1 when the powers could not be built
+//the split does not trim, so the sizes here are exactly the sizes the conversion will see
+int limbsToDecimalScratch (short n) {
+    if (n <= DEC_SPLIT_LIMBS) {
+        return n;
+    }
+    short level = decimalPowerForLimbs(n);
+    if (level < 0) {
+        return -1;
+    }
+    short m = decimalPowers[level].size;
+
+    int split = 2 * m + 2 + limbsMultiplyScratch(m + 1);
+    int high = limbsToDecimalScratch(n - m + 1), low = limbsToDecimalScratch(m);
+    if (high < 0 || low < 0) {
+        return -1;
+    }
+    int children = (high > low) ? high : low;
+    if (n > 2 * m) { //past the top level, long division with a full n limb quotient
+        split = limbsDivRemScratch(n, m);
+        return n + (m + 1) + ((split > children) ? split : children);
+    }
+    return (n - m + 1) + (m + 1) + ((split > children) ? split : children);
+}
+
+//writes the 9 digits of chunk ending just before end, returns where they start
+char* writeChunkDigits (char* end, limb_t chunk) {
+    for (short k = 0; k < DEC_CHUNK_DIGITS; k++) {
+        *--end = (char)('0' + chunk % 10);
+        chunk /= 10;
+    }
+    return end;
+}
+
+//writes the decimal digits of a (n limbs) to out, exactly width digits zero padded, or without leading zeros when width is 0
+//returns the number of characters written, scratch needs limbsToDecimalScratch(n) limbs
+int limbsToDecimalSplit (char* out, const limb_t* a, short n, int width, limb_t* scratch) {
+    if (n <= DEC_SPLIT_LIMBS) {
+        //9 digits at a time from the bottom into a local buffer, then copied out padded or trimmed
+        char digits[DEC_SPLIT_LIMBS * 10 + DEC_CHUNK_DIGITS];
+        char* end = digits + sizeof(digits);
+        char* start = end;
+
+        memcpy(scratch, a, n * sizeof(limb_t));
+        n = limbsUsed(scratch, n);
+        while (n > 0) {
+            start = writeChunkDigits(start, limbsDivSmall(scratch, n, DEC_CHUNK));
+            n = limbsUsed(scratch, n);
+        }
+        if (width == 0) {
+            while (start < end - 1 && *start == '0') {
+                start += 1;
+            }
+            memcpy(out, start, end - start);
+            return end - start;
+        }
+        int count = end - start;
+        if (count > width) { //padding zeros of the top chunk
+            start += count - width;
+            count = width;
+        }
+        memset(out, '0', width - count);
+        memcpy(out + width - count, start, count);
+        return width;
+    }
+
+    short level = decimalPowerForLimbs(n);
+    const decimalPower* p = &decimalPowers[level];
+    short m = p -> size;
+    short qn = n - m + 1;
+    int lowDigits = decimalPowerDigits(level);
+
+    if (n > 2 * m) { //only above the top level, Barrett needs a below BASE^(2m)
+        limb_t* q = scratch;
+        limb_t* r = q + n;
+        limb_t* rest = r + m + 1;
+        limbsDivRem(q, r, a, n, p -> power, m, rest);
+        int written = limbsToDecimalSplit(out, q, qn, (width == 0) ? 0 : width - lowDigits, rest);
+        return written + limbsToDecimalSplit(out + written, r, m, lowDigits, rest);
+    }
+
+    limb_t* q = scratch;
+    limb_t* r = q + qn;
+    limb_t* product = r + m + 1;
+    limb_t* rest = product + 2 * m + 2;
+
+    //Barrett: q = ((a / BASE^(m-1)) * reciprocal) / BASE^(m+1) is at most 2 below the real quotient
+    limbsMultiply(product, a + m - 1, qn, p -> reciprocal, m + 1, rest);
+    memcpy(q, product + m + 1, qn * sizeof(limb_t));
+
+    //r = a - q * P(level) only needs its low m + 1 limbs, it is below 3 * P(level)
+    limbsMultiply(product, q, qn, p -> power, m, rest);
+    limbsSub(r, a, m + 1, product, m + 1);
+    while (limbsCompare(r, m + 1, p -> power, m) != SMALL) {
+        limb_t one = 1;
+        limbsSub(r, r, m + 1, p -> power, m);
+        limbsAdd(q, q, qn, &one, 1);
+    }
+
+    if (width == 0 && limbsUsed(q, qn) == 0) {
+        return limbsToDecimalSplit(out, r, m, 0, product);
+    }
+    int written = limbsToDecimalSplit(out, q, qn, (width == 0) ? 0 : width - lowDigits, product);
+    return written + limbsToDecimalSplit(out + written, r, m, lowDigits, product);
+}
+
+//characters limbsToDecimal can write for a size limb number: 32 bits are under 10 decimal digits, plus the terminator
+int limbsDecimalLength (short size) {
+    return size * 10 + 2;
+}
+
+//writes the decimal digits of a (size limbs, no sign) to out followed by '\0', zero is written as "0"
+//out needs limbsDecimalLength(size) characters, scratch needs limbsToDecimalScratch(size) limbs
+//returns the number of digits written
+int limbsToDecimal (char* out, const limb_t* a, short size, limb_t* scratch) {
+    size = limbsUsed(a, size);
+    if (size == 0) {
+        out[0] = '0';
+        out[1] = '\0';
+        return 1;
+    }
+    int written = limbsToDecimalSplit(out, a, size, 0, scratch);
+    out[written] = '\0';
+    return written;
+}
+
+//prints a signed limb array followed by a newline, the digits are built in one buffer and written with a single call
+//returns FALSE and raises BIGINT_NO_MEMORY (printing nothing) when the buffers can not be allocated
+bool fprintLimbs (FILE* out, const limb_t* a, short size, numSign sign) {
+    STATS_BEGIN();
+    limb_t localScratch[DEC_LOCAL_SCRATCH];
+    char localText[DEC_LOCAL_SCRATCH];
+    size = limbsUsed(a, size);
+
+    int scratchSize = limbsToDecimalScratch(size);
+    int textSize = limbsDecimalLength(size) + 2; //sign and newline
+    limb_t* scratch = (scratchSize < 0) ? NULL : (scratchSize <= DEC_LOCAL_SCRATCH) ? localScratch : (limb_t*) malloc(scratchSize * sizeof(limb_t));
+    char* text = (textSize <= DEC_LOCAL_SCRATCH) ? localText : (char*) malloc(textSize);
+    if (scratch == NULL || text == NULL) {
+        if (scratch != localScratch) {
+            free(scratch);
+        }
+        if (text != localText) {
+            free(text);
+        }
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        STATS_END(STAT_PRINT);
+        return FALSE;
+    }
+    if (scratch != localScratch) {
+        STATS_ALLOC(scratchSize * sizeof(limb_t));
+    }
+    if (text != localText) {
+        STATS_ALLOC(textSize);
+    }
+
+    int length = 0;
+    if (size > 0) { //zero is printed without a sign
+        text[length++] = (sign == POSITIVE) ? '+' : '-';
+    }
+    length += limbsToDecimal(text + length, a, size, scratch);
+    text[length++] = '\n';
+    fwrite(text, 1, length, out);
+
+    if (scratch != localScratch) {
+        free(scratch);
+    }
+    if (text != localText) {
+        free(text);
+    }
+    STATS_END(STAT_PRINT);
+    return TRUE;
+}
+
+bool fprintDigits(FILE* out, BigInt b) {
+    return fprintLimbs(out, b.limb_array, b.size, b.sign);
+}
+
+bool printDigits(BigInt b) {
+    return fprintDigits(stdout, b);
+}
+
+BigInt copyBigInt (BigInt b) {
+    BigInt b1;
+    if (!initializeBigInt(&b1, b.size, b.sign)) {
+        return b1;
+    }
+    for (int i = 0; i < b.size; i++) {
+        b1.limb_array[i] = b.limb_array[i];
+    }
+    trimBigInt(&b1);
+    return b1;
+}
+
+/*
+FixedBigInt keeps its limbs inline in the struct instead of behind a calloc'ed pointer
+--> the library has a known maximum width, so a stack allocated FixedBigInt needs no malloc or free at all
+--> FIXED_LIMBS is twice MAX_LIMBS, so the full product of two BIGINT_BITS numbers still fits (same as multiplyTwoBigInt)
+--> functions take pointers because the struct is 264 bytes at 1024 bits, the result pointer may be the same as an operand
+*/
+#define FIXED_LIMBS (2 * MAX_LIMBS)
+
+typedef struct FixedBigInt {
+    limb_t limb_array[FIXED_LIMBS];// base 2^32 digits, least significant limb first
+    numSign sign; //negative = 1, positive = 0
+    short size;//number of limbs in use, limbs at and above size are always zero
+}FixedBigInt;
+
+void fixedSetZero (FixedBigInt* r) {
+    memset(r -> limb_array, 0, sizeof(r -> limb_array));
+    r -> sign = POSITIVE;
+    r -> size = 0;
+}
+
+//copies size limbs from a into r, limbs that do not fit in FIXED_LIMBS are dropped and BIGINT_OVERFLOW is raised
+void fixedSetLimbs (FixedBigInt* r, const limb_t* a, short size, numSign sign) {
+    size = limbsUsed(a, size);
+    if (size > FIXED_LIMBS) {
+        raiseBigIntStatus(BIGINT_OVERFLOW);
+        size = limbsUsed(a, FIXED_LIMBS);
+    }
+    memmove(r -> limb_array, a, size * sizeof(limb_t));
+    memset(r -> limb_array + size, 0, (FIXED_LIMBS - size) * sizeof(limb_t));
+    r -> sign = sign;
+    r -> size = size;
+}
+
+void fixedReadFromString (FixedBigInt* r, char *str) {
+    limb_t temp[FIXED_LIMBS + 1] = {0}; //one over FIXED_LIMBS, so fixedSetLimbs sees and reports a value just too wide
+    if (limbsForDecimalDigits(string_length(str)) > FIXED_LIMBS + 1) { //too many digits for temp, BIGINT_OVERFLOW and zero
+        raiseBigIntStatus(BIGINT_OVERFLOW);
+        fixedSetZero(r);
+        return;
+    }
+    fixedSetLimbs(r, temp, limbsFromDecimal(temp, str + 1), signSpecifier(str));
+}
+
+void fixedFromBigInt (FixedBigInt* r, BigInt b) {
+    fixedSetLimbs(r, b.limb_array, b.size, b.sign);
+}
+
+//the only fixed function that touches the heap, for handing a result over to the BigInt api
+BigInt fixedToBigInt (const FixedBigInt* f) {
+    BigInt b;
+    if (initializeBigInt(&b, f -> size, f -> sign)) {
+        memcpy(b.limb_array, f -> limb_array, f -> size * sizeof(limb_t));
+        trimBigInt(&b);
+    }
+    return b;
+}
+
+bool fixedIsZero (const FixedBigInt* f) {
+    return (f -> size == 0) ? TRUE : FALSE;
+}
+
+//sign not considered
+compareStatus fixedCompareMagnitude (const FixedBigInt* a, const FixedBigInt* b) {
+    return limbsCompare(a -> limb_array, a -> size, b -> limb_array, b -> size);
+}
+
+//r = a + b (signed), b's sign is taken from bSign so subtraction can reuse it
+void fixedAddSigned (FixedBigInt* r, const FixedBigInt* a, const FixedBigInt* b, numSign bSign) {
+    limb_t sum[FIXED_LIMBS + 1];
+    const FixedBigInt* big = a;
+    const FixedBigInt* small = b;
+    numSign sign = a -> sign;
+
+    if (a -> sign == bSign) {
+        if (b -> size > a -> size) {
+            big = b;
+            small = a;
+        }
+        sum[big -> size] = limbsAdd(sum, big -> limb_array, big -> size, small -> limb_array, small -> size);
+        fixedSetLimbs(r, sum, big -> size + 1, sign);
+    } else {
+        //signs differ, subtract the smaller magnitude from the larger one and keep the larger one's sign
+        if (fixedCompareMagnitude(a, b) == SMALL) {
+            big = b;
+            small = a;
+            sign = bSign;
+        }
+        limbsSub(sum, big -> limb_array, big -> size, small -> limb_array, small -> size);
+        fixedSetLimbs(r, sum, big -> size, sign);
+    }
+    if (r -> size == 0) {
+        r -> sign = POSITIVE;
+    }
+}
+
+void fixedAdd (FixedBigInt* r, const FixedBigInt* a, const FixedBigInt* b) {
+    fixedAddSigned(r, a, b, b -> sign);
+}
+
+void fixedSubtract (FixedBigInt* r, const FixedBigInt* a, const FixedBigInt* b) {
+    fixedAddSigned(r, a, b, (b -> sign == POSITIVE) ? NEGATIVE : POSITIVE);
+}
+
+void fixedMultiply (FixedBigInt* r, const FixedBigInt* a, const FixedBigInt* b) {
+    limb_t product[2 * FIXED_LIMBS];
+    numSign sign = a -> sign ^ b -> sign;
+
+    limbsMul(product, a -> limb_array, a -> size, b -> limb_array, b -> size);
+    fixedSetLimbs(r, product, a -> size + b -> size, sign);
+    if (r -> size == 0) {
+        r -> sign = POSITIVE;
+    }
+}
+
+//q = a / b and r = a % b with the same sign rules as divmodBigInt, q or r may be the same as a or b
+void fixedDivMod (FixedBigInt* q, FixedBigInt* r, const FixedBigInt* a, const FixedBigInt* b) {
+    limb_t quotient[FIXED_LIMBS];
+    limb_t rem[FIXED_LIMBS];
+    limb_t scratch[2 * FIXED_LIMBS + 1];
+    numSign qSign = (a -> sign == b -> sign) ? POSITIVE : NEGATIVE;
+    numSign rSign = a -> sign;
+    short aSize = a -> size;
+
+    if (fixedIsZero(b)) {
+        raiseBigIntStatus(BIGINT_DIVISION_BY_ZERO);
+        fixedSetZero(q);
+        fixedSetZero(r);
+        return;
+    }
+    short remSize = limbsDivRem(quotient, rem, a -> limb_array, a -> size, b -> limb_array, b -> size, scratch);
+    fixedSetLimbs(q, quotient, aSize, (limbsUsed(quotient, aSize) == 0) ? POSITIVE : qSign);
+    fixedSetLimbs(r, rem, remSize, (remSize == 0) ? POSITIVE : rSign);
+}
+
+void fixedDivide (FixedBigInt* r, const FixedBigInt* a, const FixedBigInt* b) {
+    FixedBigInt rem;
+    fixedDivMod(r, &rem, a, b);
+}
+
+void fixedMod (FixedBigInt* r, const FixedBigInt* a, const FixedBigInt* b) {
+    FixedBigInt quotient;
+    fixedDivMod(&quotient, r, a, b);
+}
+
+void printFixedDigits (const FixedBigInt* f) {
+    fprintLimbs(stdout, f -> limb_array, f -> size, f -> sign);
+}
+
+/*
+Compile time widths
+--> DEFINE_WIDTH(bits, wide) makes an unsigned type BigInt<bits> of exactly bits / 32 limbs with its own entry points:
+    add<bits> / sub<bits> (r = a + b / a - b modulo 2^bits, return the carry / borrow), compare<bits>, isZero<bits>,
+    mul<bits> (full product into a BigInt<wide>), bigIntTo<bits> and bigIntFrom<bits> to move to and from BigInt
+--> every trip count is a constant, so the loops are unrolled completely and there is no size bookkeeping at all
+--> 512 and 1024 multiply with an unrolled Comba, 2048 and 4096 do one Karatsuba step over the half width family
+    (the subtractive form, |a0 - a1| * |b1 - b0|, so every piece stays inside the half width types)
+--> BigInt / FixedBigInt are still the runtime sized versions for any other width
+*/
+#ifdef __GNUC__
+#define WIDTH_UNROLL _Pragma("GCC unroll 128")
+#else
+#define WIDTH_UNROLL
+#endif
+
+#define DEFINE_WIDTH_TYPE(bits) \
+typedef struct BigInt##bits { \
+    limb_t limb_array[(bits) / LIMB_BITS]; /* least significant limb first, always exactly bits / 32 limbs */ \
+}BigInt##bits;
+
+DEFINE_WIDTH_TYPE(512)
+DEFINE_WIDTH_TYPE(1024)
+DEFINE_WIDTH_TYPE(2048)
+DEFINE_WIDTH_TYPE(4096)
+DEFINE_WIDTH_TYPE(8192)
+
+//the width kernels below are always inlined into the generated functions, where n is a constant
+
+static inline __attribute__((always_inline)) limb_t widthAdd (limb_t* r, const limb_t* a, const limb_t* b, int n) {
+#ifdef BIGINT_X86_DISPATCH
+    //one add with carry instruction per limb, the carry stays in the flags register
+    unsigned char carry = 0;
+    WIDTH_UNROLL
+    for (int i = 0; i < n; i++) {
+        carry = _addcarry_u32(carry, a[i], b[i], &r[i]);
+    }
+    return carry;
+#else
+    limb_t carry = 0;
+    WIDTH_UNROLL
+    for (int i = 0; i < n; i++) {
+        dlimb_t limbSum = (dlimb_t)a[i] + b[i] + carry;
+        r[i] = (limb_t)limbSum;
+        carry = (limb_t)(limbSum >> LIMB_BITS);
+    }
+    return carry;
+#endif
+}
+
+static inline __attribute__((always_inline)) limb_t widthSub (limb_t* r, const limb_t* a, const limb_t* b, int n) {
+#ifdef BIGINT_X86_DISPATCH
+    unsigned char borrow = 0;
+    WIDTH_UNROLL
+    for (int i = 0; i < n; i++) {
+        borrow = _subborrow_u32(borrow, a[i], b[i], &r[i]);
+    }
+    return borrow;
+#else
+    limb_t borrow = 0;
+    WIDTH_UNROLL
+    for (int i = 0; i < n; i++) {
+        dlimb_t limbDiff = (dlimb_t)a[i] - b[i] - borrow;
+        r[i] = (limb_t)limbDiff;
+        borrow = (limb_t)(limbDiff >> LIMB_BITS) & 1;
+    }
+    return borrow;
+#endif
+}
+
+static inline __attribute__((always_inline)) compareStatus widthCompare (const limb_t* a, const limb_t* b, int n) {
+    WIDTH_UNROLL
+    for (int i = n - 1; i >= 0; i--) {
+        if (a[i] != b[i]) {
+            return (a[i] > b[i]) ? LARGE : SMALL;
+        }
+    }
+    return EQUAL;
+}
+
+static inline __attribute__((always_inline)) bool widthIsZero (const limb_t* a, int n) {
+    limb_t any = 0;
+    WIDTH_UNROLL
+    for (int i = 0; i < n; i++) {
+        any |= a[i];
+    }
+    return (any == 0) ? TRUE : FALSE;
+}
+
+//Comba like limbsMul, with both operands n limbs and r 2 * n limbs
+static inline __attribute__((always_inline)) void widthMul (limb_t* r, const limb_t* a, const limb_t* b, int n) {
+    dlimb_t acc = 0;
+    limb_t accHigh = 0;
+
+    WIDTH_UNROLL
+    for (int k = 0; k < 2 * n - 1; k++) {
+        int iStart = (k < n) ? 0 : k - n + 1;
+        int iEnd = (k < n) ? k : n - 1;
+        WIDTH_UNROLL
+        for (int i = iStart; i <= iEnd; i++) {
+            dlimb_t product = (dlimb_t)a[i] * b[k - i];
+            acc += product;
+            accHigh += (acc < product);
+        }
+        r[k] = (limb_t)acc;
+        acc = (acc >> LIMB_BITS) | ((dlimb_t)accHigh << LIMB_BITS);
+        accHigh = 0;
+    }
+    r[2 * n - 1] = (limb_t)acc;
+}
+
+#define DEFINE_WIDTH_COMMON(bits) \
+limb_t add##bits (BigInt##bits* r, const BigInt##bits* a, const BigInt##bits* b) { \
+    return widthAdd(r -> limb_array, a -> limb_array, b -> limb_array, (bits) / LIMB_BITS); \
+} \
+limb_t sub##bits (BigInt##bits* r, const BigInt##bits* a, const BigInt##bits* b) { \
+    return widthSub(r -> limb_array, a -> limb_array, b -> limb_array, (bits) / LIMB_BITS); \
+} \
+compareStatus compare##bits (const BigInt##bits* a, const BigInt##bits* b) { \
+    return widthCompare(a -> limb_array, b -> limb_array, (bits) / LIMB_BITS); \
+} \
+bool isZero##bits (const BigInt##bits* a) { \
+    return widthIsZero(a -> limb_array, (bits) / LIMB_BITS); \
+} \
+/* copies the magnitude of b into r, returns FALSE (r keeps the low bits) when b does not fit */ \
+bool bigIntTo##bits (BigInt##bits* r, BigInt b) { \
+    short size = b.size; \
+    bool fits = (size <= (bits) / LIMB_BITS) ? TRUE : FALSE; \
+    size = fits ? size : (bits) / LIMB_BITS; \
+    memcpy(r -> limb_array, b.limb_array, size * sizeof(limb_t)); \
+    memset(r -> limb_array + size, 0, ((bits) / LIMB_BITS - size) * sizeof(limb_t)); \
+    return fits; \
+} \
+BigInt bigIntFrom##bits (const BigInt##bits* a) { \
+    BigInt b; \
+    if (initializeBigInt(&b, (bits) / LIMB_BITS, POSITIVE)) { \
+        memcpy(b.limb_array, a -> limb_array, sizeof(a -> limb_array)); \
+        trimBigInt(&b); \
+    } \
+    return b; \
+}
+
+//r = a * b with an unrolled Comba
+#define DEFINE_WIDTH_COMBA(bits, wide) \
+DEFINE_WIDTH_COMMON(bits) \
+void mul##bits (BigInt##wide* r, const BigInt##bits* a, const BigInt##bits* b) { \
+    widthMul(r -> limb_array, a -> limb_array, b -> limb_array, (bits) / LIMB_BITS); \
+}
+
+//r = a * b with one Karatsuba step over the half width family: a = a1 * B + a0, b = b1 * B + b0 (B = 2^half)
+//a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 + (a0 - a1) * (b1 - b0), the last product is formed from magnitudes plus a sign
+#define DEFINE_WIDTH_KARATSUBA(bits, wide, half) \
+DEFINE_WIDTH_COMMON(bits) \
+void mul##bits (BigInt##wide* r, const BigInt##bits* a, const BigInt##bits* b) { \
+    enum { N = (bits) / LIMB_BITS, H = (half) / LIMB_BITS }; \
+    const BigInt##half* a0 = (const BigInt##half*)a -> limb_array; \
+    const BigInt##half* a1 = (const BigInt##half*)(a -> limb_array + H); \
+    const BigInt##half* b0 = (const BigInt##half*)b -> limb_array; \
+    const BigInt##half* b1 = (const BigInt##half*)(b -> limb_array + H); \
+    BigInt##half aDiff, bDiff; \
+    BigInt##bits middle; \
+    limb_t sum[N + 1]; \
+    \
+    mul##half((BigInt##bits*)r -> limb_array, a0, b0); \
+    mul##half((BigInt##bits*)(r -> limb_array + N), a1, b1); \
+    \
+    bool aNegative = (compare##half(a0, a1) == SMALL) ? TRUE : FALSE; \
+    bool bNegative = (compare##half(b1, b0) == SMALL) ? TRUE : FALSE; \
+    sub##half(&aDiff, aNegative ? a1 : a0, aNegative ? a0 : a1); \
+    sub##half(&bDiff, bNegative ? b0 : b1, bNegative ? b1 : b0); \
+    mul##half(&middle, &aDiff, &bDiff); \
+    \
+    sum[N] = widthAdd(sum, r -> limb_array, r -> limb_array + N, N); \
+    if (aNegative == bNegative) { \
+        sum[N] += widthAdd(sum, sum, middle.limb_array, N); \
+    } else { \
+        sum[N] -= widthSub(sum, sum, middle.limb_array, N); \
+    } \
+    \
+    /* r += sum * B, the carry runs on through the top quarter of r */ \
+    limb_t carry = widthAdd(r -> limb_array + H, r -> limb_array + H, sum, N + 1); \
+    WIDTH_UNROLL \
+    for (int i = H + N + 1; i < 2 * N; i++) { \
+        dlimb_t limbSum = (dlimb_t)r -> limb_array[i] + carry; \
+        r -> limb_array[i] = (limb_t)limbSum; \
+        carry = (limb_t)(limbSum >> LIMB_BITS); \
+    } \
+}
+
+DEFINE_WIDTH_COMBA(512, 1024)
+DEFINE_WIDTH_COMBA(1024, 2048)
+DEFINE_WIDTH_KARATSUBA(2048, 4096, 1024)
+DEFINE_WIDTH_KARATSUBA(4096, 8192, 2048)
+
+/*
+Barrett reduction with a per modulus context
+--> initBarrett stores the trimmed modulus m (k limbs) and its reciprocal mu = floor(BASE^(2k) / m) once, after that
+    x mod m costs two multiplies and atmost two subtractions instead of a long division (Handbook of Applied
+    Cryptography 14.42), the same trick the decimal conversion uses for its powers of ten
+--> a 2k limb window is reduced at a time: q = ((w / BASE^(k-1)) * mu) / BASE^(k+1) is at most 2 below w / m, longer
+    numbers are folded in k limbs at a time from the top, so any size of x works
+--> only the top half of the first product and the bottom half of the second are needed, below
+    BARRETT_FULL_PRODUCT_LIMBS they are formed as half schoolbook products, so a reduction costs about one k x k
+    multiply and beats the long division at every size
+--> the context is read only, temporaries come from the per thread workspace, so one context can serve every thread
+--> modBigIntCached keeps the last BARRETT_CACHE_SIZE contexts of each thread keyed by modulus, repeated reductions by
+    the same few moduli never build a context twice, freeBarrettCache releases them
+*/
+#define BARRETT_CACHE_SIZE 8 //moduli each thread keeps a context for
+#define BARRETT_FULL_PRODUCT_LIMBS 256 //from this modulus size full (Karatsuba and up) products beat half schoolbook ones, measured
+#define BARRETT_MAX_LIMBS ((SHRT_MAX - 1) / 2) //the reciprocal comes from a 2k + 1 limb numerator, which has to fit a short
+
+typedef struct barrettContext {
+    limb_t* modulus; //m, size limbs, the top limb is non zero
+    limb_t* reciprocal; //floor(BASE^(2 * size) / m), size + 1 limbs
+    short size;
+} barrettContext;
+
+void freeBarrett (barrettContext* ctx) {
+    free(ctx -> modulus); //one block holds modulus and reciprocal
+    ctx -> modulus = NULL;
+    ctx -> reciprocal = NULL;
+    ctx -> size = 0;
+}
+
+//prepares ctx for |m|, returns FALSE and raises BIGINT_DIVISION_BY_ZERO for a zero m or BIGINT_NO_MEMORY,
+//or BIGINT_OVERFLOW for m over BARRETT_MAX_LIMBS limbs
+bool initBarrett (barrettContext* ctx, BigInt m) {
+    short k = m.size;
+    ctx -> modulus = NULL;
+    ctx -> reciprocal = NULL;
+    ctx -> size = 0;
+    if (k == 0) {
+        raiseBigIntStatus(BIGINT_DIVISION_BY_ZERO);
+        return FALSE;
+    }
+    if (!checkLimbCount(2L * k + 1)) {
+        return FALSE;
+    }
+
+    //numerator BASE^(2k), its quotient, the remainder and the division workspace only live until mu is known
+    int divScratch = limbsDivRemScratch(2 * k + 1, k);
+    limb_t* block = (limb_t*) malloc((2 * k + 1) * sizeof(limb_t));
+    limb_t* numerator = (limb_t*) malloc((2 * (2 * k + 1) + k + divScratch) * sizeof(limb_t));
+    if (block == NULL || numerator == NULL) {
+        free(block);
+        free(numerator);
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        return FALSE;
+    }
+    STATS_ALLOC((2 * k + 1 + 2 * (2 * k + 1) + k + divScratch) * sizeof(limb_t));
+    limb_t* quotient = numerator + 2 * k + 1;
+    limb_t* remainder = quotient + 2 * k + 1;
+    memset(numerator, 0, 2 * k * sizeof(limb_t));
+    numerator[2 * k] = 1;
+    limbsDivRem(quotient, remainder, numerator, 2 * k + 1, m.limb_array, k, remainder + k);
+
+    ctx -> modulus = block;
+    ctx -> reciprocal = block + k;
+    ctx -> size = k;
+    memcpy(ctx -> modulus, m.limb_array, k * sizeof(limb_t));
+    memcpy(ctx -> reciprocal, quotient, (k + 1) * sizeof(limb_t)); //m >= BASE^(k-1), so mu < BASE^(k+1)
+    free(numerator);
+    return TRUE;
+}
+
+//limbs of scratch space limbsBarrettReduce needs for a k limb modulus
+int limbsBarrettScratch (short k) {
+    return 2 * k + (k + 1) + (2 * k + 2) + limbsMultiplyScratch(k + 1);
+}
+
+//columns from .. an + bn - 1 of a * b into r (an + bn - from limbs), the carry out of the columns below from is
+//dropped, so the result is atmost an + bn below (product / BASE^from), about half the limb multiplies of limbsMul
+void limbsMulHigh (limb_t* r, const limb_t* a, short an, const limb_t* b, short bn, short from) {
+    dlimb_t acc = 0;
+    limb_t accHigh = 0;
+
+    for (short k = from; k < an + bn - 1; k++) {
+        short iStart = (k < bn) ? 0 : k - bn + 1;
+        short iEnd = (k < an) ? k : an - 1;
+
+        for (short i = iStart; i <= iEnd; i++) {
+            dlimb_t product = (dlimb_t)a[i] * b[k - i];
+            acc += product;
+            accHigh += (acc < product);
+        }
+        r[k - from] = (limb_t)acc;
+        acc = (acc >> LIMB_BITS) | ((dlimb_t)accHigh << LIMB_BITS);
+        accHigh = 0;
+    }
+    r[an + bn - 1 - from] = (limb_t)acc;
+}
+
+//the low n limbs of a * b into r (n <= an + bn), nothing above column n - 1 is formed
+void limbsMulLow (limb_t* r, const limb_t* a, short an, const limb_t* b, short bn, short n) {
+    dlimb_t acc = 0;
+    limb_t accHigh = 0;
+
+    for (short k = 0; k < n; k++) {
+        short iStart = (k < bn) ? 0 : k - bn + 1;
+        short iEnd = (k < an) ? k : an - 1;
+
+        for (short i = iStart; i <= iEnd; i++) {
+            dlimb_t product = (dlimb_t)a[i] * b[k - i];
+            acc += product;
+            accHigh += (acc < product);
+        }
+        r[k] = (limb_t)acc;
+        acc = (acc >> LIMB_BITS) | ((dlimb_t)accHigh << LIMB_BITS);
+        accHigh = 0;
+    }
+}
+
+//r = w mod m for a 2k limb window w below BASE^(2k), r gets k limbs, q, product and rest are scratch from limbsBarrettReduce
+void barrettReduceWindow (limb_t* r, const limb_t* w, const barrettContext* ctx, limb_t* q, limb_t* product, limb_t* rest) {
+    short k = ctx -> size;
+
+    //q = ((w / BASE^(k-1)) * mu) / BASE^(k+1), for smaller moduli only the columns that reach q are formed
+    //(starting two columns early, so the dropped carries cost atmost one more correction below)
+    if (k >= BARRETT_FULL_PRODUCT_LIMBS) {
+        limbsMultiply(product, w + k - 1, k + 1, ctx -> reciprocal, k + 1, rest);
+        memcpy(q, product + k + 1, (k + 1) * sizeof(limb_t));
+    } else {
+        limbsMulHigh(product, w + k - 1, k + 1, ctx -> reciprocal, k + 1, k - 1);
+        memcpy(q, product + 2, (k + 1) * sizeof(limb_t));
+    }
+
+    //r = w - q * m only needs its low k + 1 limbs, it is below 4m
+    if (k >= BARRETT_FULL_PRODUCT_LIMBS) {
+        limbsMultiply(product, q, k + 1, ctx -> modulus, k, rest);
+    } else {
+        limbsMulLow(product, q, k + 1, ctx -> modulus, k, k + 1);
+    }
+    limbsSub(product, w, k + 1, product, k + 1);
+    while (limbsCompare(product, k + 1, ctx -> modulus, k) != SMALL) {
+        limbsSub(product, product, k + 1, ctx -> modulus, k);
+    }
+    memcpy(r, product, k * sizeof(limb_t));
+}
+
+//r = x mod m for an xn limb x, r needs ctx -> size limbs, scratch needs limbsBarrettScratch(ctx -> size) limbs
+//returns the number of limbs r uses
+short limbsBarrettReduce (limb_t* r, const limb_t* x, short xn, const barrettContext* ctx, limb_t* scratch) {
+    short k = ctx -> size;
+    xn = limbsUsed(x, xn);
+
+    //a one limb modulus needs no reciprocal, one hardware division per limb is enough
+    if (k == 1) {
+        dlimb_t rem = 0;
+        for (short i = xn - 1; i >= 0; i--) {
+            rem = ((rem << LIMB_BITS) | x[i]) % ctx -> modulus[0];
+        }
+        r[0] = (limb_t)rem;
+        return (rem != 0) ? 1 : 0;
+    }
+
+    limb_t* w = scratch; //2k limbs: the next chunk of x below the remainder so far
+    limb_t* q = w + 2 * k;
+    limb_t* product = q + k + 1;
+    limb_t* rest = product + 2 * k + 2;
+
+    //the first window takes up to 2k limbs from the top, so every later one is the remainder over exactly k new limbs
+    short chunk = (xn <= k) ? xn : k + (xn - 1) % k + 1;
+    memcpy(w, x + xn - chunk, chunk * sizeof(limb_t));
+    memset(w + chunk, 0, (2 * k - chunk) * sizeof(limb_t));
+    barrettReduceWindow(r, w, ctx, q, product, rest);
+    for (short pos = xn - chunk; pos > 0; pos -= k) {
+        memcpy(w, x + pos - k, k * sizeof(limb_t));
+        memcpy(w + k, r, k * sizeof(limb_t));
+        barrettReduceWindow(r, w, ctx, q, product, rest);
+    }
+    return limbsUsed(r, k);
+}
+
+//x mod |m| with the sign of x (same as modBigInt) through a ready context
+BigInt barrettReduceBigInt (BigInt x, const barrettContext* ctx) {
+    STATS_BEGIN();
+    BigInt r;
+    limb_t* work = reserveWorkspace(limbsBarrettScratch(ctx -> size));
+    if (work == NULL || !initializeBigInt(&r, ctx -> size, x.sign)) {
+        STATS_END(STAT_BARRETT);
+        return (BigInt){NULL, POSITIVE, 0, 0};
+    }
+    r.size = limbsBarrettReduce(r.limb_array, x.limb_array, x.size, ctx, work);
+    if (r.size == 0) {
+        r.sign = POSITIVE;
+    }
+    STATS_END(STAT_BARRETT);
+    return r;
+}
+
+__thread barrettContext barrettCache[BARRETT_CACHE_SIZE];
+__thread long barrettCacheUsed[BARRETT_CACHE_SIZE]; //when each entry was last looked up, 0 for an empty entry
+__thread long barrettCacheClock = 0;
+
+//the calling thread's context for |m|, built (replacing the least recently used one) when it is not cached yet
+//the pointer stays valid until BARRETT_CACHE_SIZE other moduli have been looked up, NULL when it cannot be built
+const barrettContext* cachedBarrett (BigInt m) {
+    short k = m.size;
+    short oldest = 0;
+
+    barrettCacheClock += 1;
+    for (short i = 0; i < BARRETT_CACHE_SIZE; i++) {
+        barrettContext* ctx = &barrettCache[i];
+        if (barrettCacheUsed[i] != 0 && ctx -> size == k && memcmp(ctx -> modulus, m.limb_array, k * sizeof(limb_t)) == 0) {
+            barrettCacheUsed[i] = barrettCacheClock;
+            return ctx;
+        }
+        if (barrettCacheUsed[i] < barrettCacheUsed[oldest]) {
+            oldest = i;
+        }
+    }
+
+    barrettContext fresh;
+    if (!initBarrett(&fresh, m)) {
+        return NULL;
+    }
+    if (barrettCacheUsed[oldest] != 0) {
+        freeBarrett(&barrettCache[oldest]);
+    }
+    barrettCache[oldest] = fresh;
+    barrettCacheUsed[oldest] = barrettCacheClock;
+    return &barrettCache[oldest];
+}
+
+//x mod m like modBigInt, with the context for m taken from (or added to) the calling thread's cache
+//a zero m raises BIGINT_DIVISION_BY_ZERO and gives 0, moduli too wide for a context go through modBigInt
+BigInt modBigIntCached (BigInt x, BigInt m) {
+    if (m.size > BARRETT_MAX_LIMBS) {
+        return modBigInt(x, m);
+    }
+    const barrettContext* ctx = cachedBarrett(m);
+    if (ctx == NULL) {
+        BigInt zero;
+        initializeBigInt(&zero, 0, POSITIVE);
+        return zero;
+    }
+    return barrettReduceBigInt(x, ctx);
+}
+
+void freeBarrettCache () {
+    for (short i = 0; i < BARRETT_CACHE_SIZE; i++) {
+        if (barrettCacheUsed[i] != 0) {
+            freeBarrett(&barrettCache[i]);
+            barrettCacheUsed[i] = 0;
+        }
+    }
+}
+
+/*
+Montgomery modular exponentiation
+--> for an odd modulus n of size limbs let R = BASE^size, numbers are kept in Montgomery form x * R mod n
+--> montgomeryMultiply gives a * b * R^-1 mod n, the multiply and the reduction are fused limb by limb (CIOS),
+    so no double width product and no division is ever formed
+--> the context precomputes n' = -n^-1 mod BASE, R mod n (Montgomery one) and R^2 mod n (to enter Montgomery form)
+    once per modulus, so many exponentiations with the same modulus only pay for it once
+--> montgomerySquare squares with the squaring kernel first and reduces afterwards, squarings are most of the work
+--> modPowBigInt walks the exponent with a sliding window over the odd powers base^1, base^3, ... base^(2^k - 1)
+*/
+typedef struct montgomeryContext {
+    limb_t* modulus; //n, size limbs, odd
+    limb_t* one; //R mod n, 1 in Montgomery form
+    limb_t* rSquared; //R^2 mod n
+    limb_t* work; //2 * size + 1 limbs for montgomeryMultiply / montgomerySquare
+    limb_t nPrime; //-n^-1 mod BASE
+    short size;
+} montgomeryContext;
+
+//r = a * b * R^-1 mod n for a, b < n (size limbs each), r may be the same array as a or b
+void montgomeryMultiply (limb_t* r, const limb_t* a, const limb_t* b, montgomeryContext* ctx) {
+    short n = ctx -> size;
+    const limb_t* mod = ctx -> modulus;
+    limb_t* t = ctx -> work;
+    memset(t, 0, (n + 2) * sizeof(limb_t));
+
+    for (short i = 0; i < n; i++) {
+        //t += a * b[i]
+        dlimb_t carry = 0;
+        for (short j = 0; j < n; j++) {
+            dlimb_t cur = (dlimb_t)a[j] * b[i] + t[j] + carry;
+            t[j] = (limb_t)cur;
+            carry = cur >> LIMB_BITS;
+        }
+        dlimb_t cur = (dlimb_t)t[n] + carry;
+        t[n] = (limb_t)cur;
+        t[n + 1] = (limb_t)(cur >> LIMB_BITS);
+
+        //t = (t + m * n) / BASE, m is chosen so the lowest limb becomes zero and can be shifted out
+        limb_t m = t[0] * ctx -> nPrime;
+        cur = (dlimb_t)m * mod[0] + t[0];
+        carry = cur >> LIMB_BITS;
+        for (short j = 1; j < n; j++) {
+            cur = (dlimb_t)m * mod[j] + t[j] + carry;
+            t[j - 1] = (limb_t)cur;
+            carry = cur >> LIMB_BITS;
+        }
+        cur = (dlimb_t)t[n] + carry;
+        t[n - 1] = (limb_t)cur;
+        t[n] = t[n + 1] + (limb_t)(cur >> LIMB_BITS);
+    }
+
+    //t < 2n here, one conditional subtraction brings it below n
+    if (t[n] != 0 || limbsCompare(t, n, mod, n) != SMALL) {
+        limbsSub(t, t, n + 1, mod, n);
+    }
+    memcpy(r, t, n * sizeof(limb_t));
+}
+
+//r = a * a * R^-1 mod n for a < n, r may be the same array as a
+//the square is formed first with the squaring kernel (half the cross products) and then reduced one limb at a time
+void montgomerySquare (limb_t* r, const limb_t* a, montgomeryContext* ctx) {
+    short n = ctx -> size;
+    const limb_t* mod = ctx -> modulus;
+    limb_t* t = ctx -> work;
+
+    limbsSqr(t, a, n);
+    t[2 * n] = 0;
+
+    //t = (t + m * n) / BASE once per limb, every m clears the lowest remaining limb
+    for (short i = 0; i < n; i++) {
+        limb_t m = t[i] * ctx -> nPrime;
+        dlimb_t carry = 0;
+        for (short j = 0; j < n; j++) {
+            dlimb_t cur = (dlimb_t)m * mod[j] + t[i + j] + carry;
+            t[i + j] = (limb_t)cur;
+            carry = cur >> LIMB_BITS;
+        }
+        for (short j = i + n; carry != 0 && j <= 2 * n; j++) {
+            dlimb_t cur = (dlimb_t)t[j] + carry;
+            t[j] = (limb_t)cur;
+            carry = cur >> LIMB_BITS;
+        }
+    }
+
+    //t[n .. 2n] < 2n, one conditional subtraction brings it below n
+    if (t[2 * n] != 0 || limbsCompare(t + n, n, mod, n) != SMALL) {
+        limbsSub(t + n, t + n, n + 1, mod, n);
+    }
+    memcpy(r, t + n, n * sizeof(limb_t));
+}
+
+void freeMontgomery (montgomeryContext* ctx) {
+    free(ctx -> modulus);
+    ctx -> modulus = NULL;
+    ctx -> one = NULL;
+    ctx -> rSquared = NULL;
+    ctx -> work = NULL;
+    ctx -> size = 0;
+}
+
+//prepares ctx for the odd modulus m (sign ignored), returns FALSE if m is even or 1
+//or when the context can not be allocated, that also raises BIGINT_NO_MEMORY
+//a modulus whose R^2 mod m needs a numerator over SHRT_MAX limbs raises BIGINT_OVERFLOW and gives FALSE
+bool initMontgomery (montgomeryContext* ctx, BigInt m) {
+    short n = m.size;
+
+    if (n == 0 || (m.limb_array[0] & 1) == 0 || (n == 1 && m.limb_array[0] == 1)) {
+        return FALSE;
+    }
+    if (!checkLimbCount(2L * n + 1)) {
+        return FALSE;
+    }
+
+    //one block holds modulus, one, rSquared, work and the temporaries of the two divisions below
+    int divScratch = limbsDivRemScratch(2 * n + 1, n);
+    limb_t* block = (limb_t*) calloc(3 * n + (2 * n + 1) + 2 * (2 * n + 1) + divScratch, sizeof(limb_t));
+    if (block == NULL) {
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        return FALSE;
+    }
+    STATS_ALLOC((3 * n + (2 * n + 1) + 2 * (2 * n + 1) + divScratch) * sizeof(limb_t));
+    ctx -> size = n;
+    ctx -> modulus = block;
+    ctx -> one = block + n;
+    ctx -> rSquared = block + 2 * n;
+    ctx -> work = block + 3 * n;
+    memcpy(ctx -> modulus, m.limb_array, n * sizeof(limb_t));
+
+    //n0 * x = 1 mod 2^k doubles k on every step: x = x * (2 - n0 * x), an odd n0 is its own inverse mod 8
+    limb_t x = ctx -> modulus[0];
+    for (short i = 0; i < 4; i++) {
+        x *= 2 - ctx -> modulus[0] * x;
+    }
+    ctx -> nPrime = (limb_t)0 - x;
+
+    //R mod n and R^2 mod n by one division each
+    limb_t* power = ctx -> work + 2 * n + 1;
+    limb_t* quotient = power + 2 * n + 1;
+    power[n] = 1;
+    limbsDivRem(quotient, ctx -> one, power, n + 1, ctx -> modulus, n, quotient + 2 * n + 1);
+    power[n] = 0;
+    power[2 * n] = 1;
+    limbsDivRem(quotient, ctx -> rSquared, power, 2 * n + 1, ctx -> modulus, n, quotient + 2 * n + 1);
+
+    return TRUE;
+}
+
+//number of bits up to and including the highest set bit, an int because 1024 limbs already have 32768 bits
+int limbsBitLength (const limb_t* a, short size) {
+    size = limbsUsed(a, size);
+    if (size == 0) {
+        return 0;
+    }
+    return size * LIMB_BITS - limbLeadingZeros(a[size - 1]);
+}
+
+//base^exponent mod n with a ready context, base must already be reduced (< n, size limbs), r gets size limbs
+//returns FALSE and raises BIGINT_NO_MEMORY when the window table can not be allocated, r is left alone then
+bool montgomeryPower (limb_t* r, const limb_t* base, const limb_t* exponent, short expSize, montgomeryContext* ctx) {
+    short n = ctx -> size;
+    int bits = limbsBitLength(exponent, expSize);
+    //wider windows save multiplies but cost a bigger table, these sizes minimise squarings + multiplies + table
+    short window = (bits > 768) ? 6 : (bits > 256) ? 5 : (bits > 80) ? 4 : (bits > 24) ? 3 : 1;
+    short tableSize = 1 << (window - 1);
+    limb_t* table = (limb_t*) malloc((tableSize + 2) * n * sizeof(limb_t));
+    if (table == NULL) {
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        return FALSE;
+    }
+    STATS_ALLOC((tableSize + 2) * n * sizeof(limb_t));
+    limb_t* acc = table + tableSize * n;
+    limb_t* square = acc + n;
+
+    //table[i] = base^(2i + 1) in Montgomery form
+    montgomeryMultiply(table, base, ctx -> rSquared, ctx);
+    montgomerySquare(square, table, ctx);
+    for (short i = 1; i < tableSize; i++) {
+        montgomeryMultiply(table + i * n, table + (i - 1) * n, square, ctx);
+    }
+
+    memcpy(acc, ctx -> one, n * sizeof(limb_t));
+    int i = bits - 1;
+    while (i >= 0) {
+        if (((exponent[i / LIMB_BITS] >> (i % LIMB_BITS)) & 1) == 0) {
+            montgomerySquare(acc, acc, ctx);
+            i -= 1;
+            continue;
+        }
+        //longest window starting at bit i that ends on a set bit
+        int low = (i - window + 1 > 0) ? i - window + 1 : 0;
+        while (((exponent[low / LIMB_BITS] >> (low % LIMB_BITS)) & 1) == 0) {
+            low += 1;
+        }
+        int value = 0;
+        for (int k = i; k >= low; k--) {
+            value = (value << 1) | ((exponent[k / LIMB_BITS] >> (k % LIMB_BITS)) & 1);
+            montgomerySquare(acc, acc, ctx);
+        }
+        montgomeryMultiply(acc, acc, table + (value >> 1) * n, ctx);
+        i = low - 1;
+    }
+
+    //leave Montgomery form: multiply by plain 1
+    memset(square, 0, n * sizeof(limb_t));
+    square[0] = 1;
+    montgomeryMultiply(r, acc, square, ctx);
+    free(table);
+    return TRUE;
+}
+
+//base^exponent mod modulus, the result is in [0, |modulus|), exponent must not be negative
+//odd moduli go through Montgomery multiplication, even ones fall back to multiply and divide
+//a zero modulus or negative exponent raises BIGINT_INVALID_ARGUMENT and gives 0
+//a modulus over BARRETT_MAX_LIMBS limbs raises BIGINT_OVERFLOW and gives 0, the square of a residue would not fit a BigInt
+BigInt modPowBigInt (BigInt base, BigInt exponent, BigInt modulus) {
+    STATS_BEGIN();
+    BigInt result;
+    BigInt m = modulus;
+    m.sign = POSITIVE;
+
+    if (isBigIntZero(modulus) || exponent.sign == NEGATIVE) {
+        raiseBigIntStatus(BIGINT_INVALID_ARGUMENT);
+        STATS_END(STAT_MODPOW);
+        initializeBigInt(&result, 0, POSITIVE);
+        return result;
+    }
+    if (!checkLimbCount(2L * m.size + 1)) {
+        STATS_END(STAT_MODPOW);
+        initializeBigInt(&result, 0, POSITIVE);
+        return result;
+    }
+
+    //reduce the base into [0, m)
+    BigInt reduced = modBigInt(base, m);
+    if (reduced.sign == NEGATIVE) {
+        BigInt positive = addTwoNumbers(reduced, m);
+        freeBigInt(&reduced);
+        reduced = positive;
+    }
+
+    montgomeryContext ctx;
+    if (initMontgomery(&ctx, m)) {
+        short n = ctx.size;
+        limb_t* padded = (limb_t*) calloc(n, sizeof(limb_t));
+        if (padded == NULL) {
+            raiseBigIntStatus(BIGINT_NO_MEMORY);
+        } else {
+            STATS_ALLOC(n * sizeof(limb_t));
+        }
+        if (padded != NULL && initializeBigInt(&result, n, POSITIVE)) {
+            memcpy(padded, reduced.limb_array, reduced.size * sizeof(limb_t));
+            if (!montgomeryPower(result.limb_array, padded, exponent.limb_array, exponent.size, &ctx)) {
+                memset(result.limb_array, 0, n * sizeof(limb_t));
+            }
+            trimBigInt(&result);
+        } else {
+            result = (BigInt){NULL, POSITIVE, 0, 0};
+        }
+        free(padded);
+        freeMontgomery(&ctx);
+        STATS_END(STAT_MODPOW);
+        freeBigInt(&reduced);
+        return result;
+    }
+
+    //even modulus (or 1): left to right square and multiply, every step reduced by Barrett against one context
+    barrettContext barrett;
+    if (!initBarrett(&barrett, m) || !initializeBigInt(&result, 1, POSITIVE)) {
+        freeBarrett(&barrett);
+        freeBigInt(&reduced);
+        STATS_END(STAT_MODPOW);
+        initializeBigInt(&result, 0, POSITIVE);
+        return result;
+    }
+    result.limb_array[0] = 1;
+    for (int i = bigIntBitLength(exponent) - 1; i >= 0; i--) {
+        BigInt squared = squareBigInt(result);
+        freeBigInt(&result);
+        result = barrettReduceBigInt(squared, &barrett);
+        freeBigInt(&squared);
+        if ((exponent.limb_array[i / LIMB_BITS] >> (i % LIMB_BITS)) & 1) {
+            BigInt product = karatsubaMultiply(result, reduced);
+            freeBigInt(&result);
+            result = barrettReduceBigInt(product, &barrett);
+            freeBigInt(&product);
+        }
+    }
+    BigInt final = barrettReduceBigInt(result, &barrett); //covers exponent 0 and modulus 1
+    freeBigInt(&result);
+    freeBigInt(&reduced);
+    freeBarrett(&barrett);
+    STATS_END(STAT_MODPOW);
+    return final;
+}
+
+/*
+GCD : gcdBigInt, extendedGcdBigInt and modInverseBigInt
+--> Lehmer (TAOCP vol 2, 4.5.2 Algorithm L): Euclid runs on the leading 32 bits of x and y with single word quotients,
+    the quotients are collected in a matrix (A B, C D) until a word quotient could differ from the real one, then one
+    pass x, y = A x + B y, C x + D y applies all of them, so most quotient steps cost no multi limb work at all
+--> when not even the first word quotient is safe (x much bigger than y) one full division step is taken instead
+--> numbers that fit in 64 bits are finished with binary GCD on one dlimb_t, shifts and subtractions only
+--> the extended version carries the cofactor s of the first operand (g = s * a + t * b) through the same matrices,
+    Euclid's cofactors alternate in sign so only magnitudes are kept and the sign comes from the number of quotient
+    steps, t is recovered at the end as (g - s * a) / b
+*/
+#define GCD_WORD_LIMBS 2 //pairs this small are finished by binary GCD on a dlimb_t
+
+typedef struct gcdState {
+    limb_t* x; //the remainder pair, x >= y, both valid over the first xn limbs
+    limb_t* y;
+    limb_t* nextX; //where the next pair is built before the pointers rotate
+    limb_t* nextY;
+    limb_t* quotient; //a division step's quotient
+    limb_t* divScratch;
+    limb_t* s0; //cofactor magnitudes of x and y, valid over the first sn limbs, NULL when they are not wanted
+    limb_t* s1;
+    limb_t* nextS;
+    limb_t* product; //quotient * s1 in a division step
+    short xn, yn, sn;
+    long steps; //quotient steps taken, the cofactor of x is negative when this is odd
+} gcdState;
+
+//limbs of scratch space limbsGcd needs when the bigger operand has n limbs
+int limbsGcdScratch (short n) {
+    n += 1;
+    return 5 * n + limbsDivRemScratch(n, n) + 4 * (n + 2);
+}
+
+//binary GCD of two machine words
+dlimb_t wordGcd (dlimb_t u, dlimb_t v) {
+    if (u == 0 || v == 0) {
+        return u | v;
+    }
+    int shift = __builtin_ctzll(u | v); //the common factor of two
+    u >>= __builtin_ctzll(u);
+    while (v != 0) {
+        v >>= __builtin_ctzll(v);
+        if (u > v) {
+            dlimb_t t = u;
+            u = v;
+            v = t;
+        }
+        v -= u;
+    }
+    return u << shift;
+}
+
+//floor(a / 2^k) for an n limb a, k is chosen by the caller so the result fits in one limb
+limb_t limbsTopBits (const limb_t* a, short n, int k) {
+    short i = k / LIMB_BITS;
+    short bit = k % LIMB_BITS;
+    limb_t low = (i < n) ? a[i] >> bit : 0;
+    limb_t high = (bit > 0 && i + 1 < n) ? a[i + 1] << (LIMB_BITS - bit) : 0;
+    return low | high;
+}
+
+//r = x * a - y * b over n limbs, the caller knows the result is not negative, r may be a or b
+void limbsMulSubMul (limb_t* r, const limb_t* a, limb_t x, const limb_t* b, limb_t y, short n) {
+    dlimb_t carryA = 0, carryB = 0;
+    limb_t borrow = 0;
+    for (short i = 0; i < n; i++) {
+        dlimb_t pa = (dlimb_t)a[i] * x + carryA;
+        dlimb_t pb = (dlimb_t)b[i] * y + carryB;
+        dlimb_t t = (dlimb_t)(limb_t)pa - (limb_t)pb - borrow;
+        r[i] = (limb_t)t;
+        borrow = (t >> LIMB_BITS) ? 1 : 0; //wrapped below zero
+        carryA = pa >> LIMB_BITS;
+        carryB = pb >> LIMB_BITS;
+    }
+}
+
+//r = x * a + y * b over n limbs, returns the limb carried out of the top, r may be a or b
+limb_t limbsMulAddMul (limb_t* r, const limb_t* a, limb_t x, const limb_t* b, limb_t y, short n) {
+    dlimb_t carryA = 0, carryB = 0, carry = 0;
+    for (short i = 0; i < n; i++) {
+        dlimb_t pa = (dlimb_t)a[i] * x + carryA;
+        dlimb_t pb = (dlimb_t)b[i] * y + carryB;
+        dlimb_t t = (dlimb_t)(limb_t)pa + (limb_t)pb + carry;
+        r[i] = (limb_t)t;
+        carry = t >> LIMB_BITS;
+        carryA = pa >> LIMB_BITS;
+        carryB = pb >> LIMB_BITS;
+    }
+    return (limb_t)(carryA + carryB + carry);
+}
+
+//one Euclid step with a full division: x, y = y, x mod y and s0, s1 = s1, s0 + q * s1
+void gcdDivisionStep (gcdState* st) {
+    short rn = limbsDivRem(st -> quotient, st -> nextY, st -> x, st -> xn, st -> y, st -> yn, st -> divScratch);
+    memset(st -> nextY + rn, 0, (st -> yn - rn) * sizeof(limb_t)); //the new y is read over the new xn = yn limbs
+
+    if (st -> s0 != NULL) {
+        short qn = limbsUsed(st -> quotient, st -> xn);
+        short size = st -> sn;
+        if (qn > 0 && st -> sn > 0) {
+            size = qn + st -> sn;
+            limbsMul(st -> product, st -> quotient, qn, st -> s1, st -> sn);
+            st -> nextS[size] = limbsAdd(st -> nextS, st -> product, size, st -> s0, st -> sn);
+        } else {
+            memcpy(st -> nextS, st -> s0, st -> sn * sizeof(limb_t));
+            st -> nextS[size] = 0;
+        }
+        size = limbsUsed(st -> nextS, size + 1);
+        if (size > st -> sn) { //s1 becomes the new s0 and is read over the new sn limbs
+            memset(st -> s1 + st -> sn, 0, (size - st -> sn) * sizeof(limb_t));
+            st -> sn = size;
+        }
+        limb_t* old = st -> s0;
+        st -> s0 = st -> s1;
+        st -> s1 = st -> nextS;
+        st -> nextS = old;
+    }
+
+    limb_t* old = st -> x;
+    st -> x = st -> y;
+    st -> y = st -> nextY;
+    st -> nextY = old;
+    st -> xn = st -> yn;
+    st -> yn = rn;
+    st -> steps += 1;
+}
+
+//Lehmer step on the leading bits of x and y, returns FALSE (changing nothing) when no word quotient was safe
+bool gcdLehmerStep (gcdState* st) {
+    int k = limbsBitLength(st -> x, st -> xn) - LIMB_BITS;
+    if (k < 0) {
+        k = 0;
+    }
+    int64_t xh = limbsTopBits(st -> x, st -> xn, k);
+    int64_t yh = limbsTopBits(st -> y, st -> xn, k);
+    int64_t a = 1, b = 0, c = 0, d = 1;
+    short count = 0;
+
+    //the quotient of the leading bits is the real one while both ends of its range agree
+    while (yh + c != 0 && yh + d != 0) {
+        int64_t q = (xh + a) / (yh + c);
+        if (q != (xh + b) / (yh + d)) {
+            break;
+        }
+        int64_t t = a - q * c;
+        a = c;
+        c = t;
+        t = b - q * d;
+        b = d;
+        d = t;
+        t = xh - q * yh;
+        xh = yh;
+        yh = t;
+        count += 1;
+    }
+    if (count == 0) {
+        return FALSE;
+    }
+
+    //the signs alternate: a >= 0, b <= 0, c <= 0, d >= 0 after an even count and the other way round after an odd one
+    limb_t ma = (limb_t)((a < 0) ? -a : a), mb = (limb_t)((b < 0) ? -b : b);
+    limb_t mc = (limb_t)((c < 0) ? -c : c), md = (limb_t)((d < 0) ? -d : d);
+    short n = st -> xn;
+    if (count % 2 == 0) {
+        limbsMulSubMul(st -> nextX, st -> x, ma, st -> y, mb, n);
+        limbsMulSubMul(st -> nextY, st -> y, md, st -> x, mc, n);
+    } else {
+        limbsMulSubMul(st -> nextX, st -> y, mb, st -> x, ma, n);
+        limbsMulSubMul(st -> nextY, st -> x, mc, st -> y, md, n);
+    }
+
+    //the cofactors have opposite signs too, so their magnitudes simply add
+    if (st -> s0 != NULL) {
+        short sn = st -> sn;
+        st -> nextS[sn] = limbsMulAddMul(st -> nextS, st -> s0, ma, st -> s1, mb, sn);
+        st -> s1[sn] = limbsMulAddMul(st -> s1, st -> s0, mc, st -> s1, md, sn); //s1 is read before each limb is written
+        limb_t* old = st -> s0;
+        st -> s0 = st -> nextS;
+        st -> nextS = old;
+        sn += 1;
+        while (sn > 0 && st -> s0[sn - 1] == 0 && st -> s1[sn - 1] == 0) {
+            sn -= 1;
+        }
+        st -> sn = sn;
+    }
+
+    limb_t* old = st -> x;
+    st -> x = st -> nextX;
+    st -> nextX = old;
+    old = st -> y;
+    st -> y = st -> nextY;
+    st -> nextY = old;
+    st -> xn = limbsUsed(st -> x, n);
+    st -> yn = limbsUsed(st -> y, n);
+    st -> steps += count;
+    return TRUE;
+}
+
+//gcd of a (an limbs) and b (bn limbs) into g, which needs max(an, bn) limbs, returns the number of limbs it uses
+//with s not NULL the cofactor of a is written there as well: g = s * a + t * b for some t, s needs max(an, bn) + 1 limbs
+//and *sSize, *sSign receive its limbs and sign, scratch needs limbsGcdScratch(max(an, bn)) limbs
+short limbsGcd (limb_t* g, limb_t* s, short* sSize, numSign* sSign, const limb_t* a, short an, const limb_t* b, short bn, limb_t* scratch) {
+    an = limbsUsed(a, an);
+    bn = limbsUsed(b, bn);
+    short n = max(an, bn) + 1;
+    gcdState st;
+
+    st.x = scratch;
+    st.y = st.x + n;
+    st.nextX = st.y + n;
+    st.nextY = st.nextX + n;
+    st.quotient = st.nextY + n;
+    st.divScratch = st.quotient + n;
+    memcpy(st.x, a, an * sizeof(limb_t));
+    memset(st.x + an, 0, (n - an) * sizeof(limb_t));
+    memcpy(st.y, b, bn * sizeof(limb_t));
+    memset(st.y + bn, 0, (n - bn) * sizeof(limb_t));
+    st.xn = an;
+    st.yn = bn;
+    st.steps = 0;
+    st.s0 = NULL;
+    if (s != NULL) {
+        st.s0 = st.divScratch + limbsDivRemScratch(n, n);
+        st.s1 = st.s0 + n + 2;
+        st.nextS = st.s1 + n + 2;
+        st.product = st.nextS + n + 2;
+        st.s0[0] = 1;
+        st.s1[0] = 0;
+        st.sn = 1;
+    }
+
+    //Lehmer needs x >= y, a first step with quotient 0 swaps them
+    if (limbsCompare(st.x, st.xn, st.y, st.yn) == SMALL) {
+        gcdDivisionStep(&st);
+    }
+    while (st.yn > 0 && (s != NULL || st.xn > GCD_WORD_LIMBS)) {
+        if (!gcdLehmerStep(&st)) {
+            gcdDivisionStep(&st);
+        }
+    }
+
+    if (s != NULL) {
+        memcpy(s, st.s0, st.sn * sizeof(limb_t));
+        *sSize = limbsUsed(s, st.sn);
+        *sSign = (st.steps % 2 == 0 || *sSize == 0) ? POSITIVE : NEGATIVE;
+    }
+    if (st.yn == 0) {
+        memcpy(g, st.x, st.xn * sizeof(limb_t));
+        return st.xn;
+    }
+
+    //both fit in 64 bits now
+    dlimb_t u = st.x[0] | ((st.xn > 1) ? (dlimb_t)st.x[1] << LIMB_BITS : 0);
+    dlimb_t v = st.y[0] | ((st.yn > 1) ? (dlimb_t)st.y[1] << LIMB_BITS : 0);
+    dlimb_t w = wordGcd(u, v);
+    short gn = 0;
+    while (w != 0) {
+        g[gn++] = (limb_t)w;
+        w >>= LIMB_BITS;
+    }
+    return gn;
+}
+
+//gcd of |a| and |b|, never negative, gcd(0, 0) is 0
+BigInt gcdBigInt (BigInt a, BigInt b) {
+    STATS_BEGIN();
+    BigInt g;
+    short n = max(a.size, b.size);
+
+    if (!initializeBigInt(&g, n, POSITIVE)) {
+        STATS_END(STAT_GCD);
+        return g;
+    }
+    limb_t* scratch = (limb_t*) malloc(limbsGcdScratch(n) * sizeof(limb_t));
+    if (scratch == NULL) {
+        raiseBigIntStatus(BIGINT_NO_MEMORY); //g stays zero
+        g.size = 0;
+        STATS_END(STAT_GCD);
+        return g;
+    }
+    STATS_ALLOC(limbsGcdScratch(n) * sizeof(limb_t));
+    g.size = limbsGcd(g.limb_array, NULL, NULL, NULL, a.limb_array, a.size, b.limb_array, b.size, scratch);
+    free(scratch);
+    STATS_END(STAT_GCD);
+    return g;
+}
+
+//g = gcd(a, b) = a * x + b * y, x and y receive the Bezout coefficients (either may be NULL when it is not needed)
+//Euclid's smallest pair: |x| <= |b| and |y| <= |a|, gcd(a, 0) = |a| gives x = +-1 and y = 0
+BigInt extendedGcdBigInt (BigInt a, BigInt b, BigInt* x, BigInt* y) {
+    STATS_BEGIN();
+    BigInt g, s;
+    short n = max(a.size, b.size);
+    bool allocated = initializeBigInt(&g, n, POSITIVE);
+    allocated = initializeBigInt(&s, n + 1, POSITIVE) && allocated;
+
+    limb_t* scratch = allocated ? (limb_t*) malloc(limbsGcdScratch(n) * sizeof(limb_t)) : NULL;
+    if (scratch == NULL) {
+        //every result comes back as zero, still owning whatever limbs it got so freeBigInt works on it
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        g.size = 0;
+        s.size = 0;
+        s.sign = POSITIVE;
+    } else {
+        STATS_ALLOC(limbsGcdScratch(n) * sizeof(limb_t));
+        g.size = limbsGcd(g.limb_array, s.limb_array, &s.size, &s.sign, a.limb_array, a.size, b.limb_array, b.size, scratch);
+        free(scratch);
+        if (a.sign == NEGATIVE && s.size > 0) { //s was the cofactor of |a|
+            s.sign = (s.sign == POSITIVE) ? NEGATIVE : POSITIVE;
+        }
+    }
+
+    if (y != NULL) {
+        if (scratch == NULL || isBigIntZero(b)) {
+            initializeBigInt(y, 0, POSITIVE);
+        } else {
+            //y = (g - x * a) / b, the division is exact
+            BigInt product = multiplyBigInt(s, a);
+            BigInt rest = subtracTwotBigInts(g, product);
+            *y = divideBigInt(rest, b);
+            freeBigInt(&product);
+            freeBigInt(&rest);
+        }
+    }
+    if (x != NULL) {
+        *x = s;
+    } else {
+        freeBigInt(&s);
+    }
+    STATS_END(STAT_GCD);
+    return g;
+}
+
+//x in [0, |m|) with a * x = 1 mod m, a zero modulus or an a that shares a factor with m raises BIGINT_INVALID_ARGUMENT
+//and gives 0, only the cofactor of a is tracked so this costs one Lehmer GCD and nothing else
+BigInt modInverseBigInt (BigInt a, BigInt m) {
+    STATS_BEGIN();
+    BigInt result;
+    short mn = m.size;
+    short n = max(a.size, mn);
+
+    limb_t* block = (mn == 0) ? NULL : (limb_t*) malloc((2 * n + 1 + limbsGcdScratch(n)) * sizeof(limb_t));
+    if (block == NULL) {
+        raiseBigIntStatus((mn == 0) ? BIGINT_INVALID_ARGUMENT : BIGINT_NO_MEMORY);
+        STATS_END(STAT_GCD);
+        initializeBigInt(&result, 0, POSITIVE);
+        return result;
+    }
+    STATS_ALLOC((2 * n + 1 + limbsGcdScratch(n)) * sizeof(limb_t));
+    limb_t* g = block;
+    limb_t* s = g + n;
+    short sn;
+    numSign sSign;
+    short gn = limbsGcd(g, s, &sn, &sSign, a.limb_array, a.size, m.limb_array, mn, s + n + 1);
+
+    if (gn != 1 || g[0] != 1) {
+        raiseBigIntStatus(BIGINT_INVALID_ARGUMENT);
+        free(block);
+        STATS_END(STAT_GCD);
+        initializeBigInt(&result, 0, POSITIVE);
+        return result;
+    }
+    if (a.sign == NEGATIVE && sn > 0) { //s was the cofactor of |a|
+        sSign = (sSign == POSITIVE) ? NEGATIVE : POSITIVE;
+    }
+
+    //|s| < |m|, a negative cofactor is brought into range by one addition of |m|
+    if (initializeBigInt(&result, mn, POSITIVE)) {
+        if (sSign == NEGATIVE) {
+            limbsSub(result.limb_array, m.limb_array, mn, s, sn);
+        } else {
+            memcpy(result.limb_array, s, sn * sizeof(limb_t));
+        }
+        trimBigInt(&result);
+    }
+    free(block);
+    STATS_END(STAT_GCD);
+    return result;
+}
+
+/*
+Primes : isProbablePrimeBigInt, nextPrimeBigInt and randomPrimeBigInt
+--> trial division first: the odd primes below SMALL_PRIME_LIMIT are packed into groups whose product fits in a limb,
+    one pass of single limb remainders per group (limbsModSmall) then gives the residue by every prime in the group,
+    so about 1000 primes cost about 500 short passes instead of 1000 divisions
+--> survivors get Miller-Rabin rounds: base 2 first, then random bases, each one Montgomery exponentiation by the odd
+    part d of n - 1 followed by up to s - 1 squarings in Montgomery form, against one context for all rounds
+--> the generator keeps the residues of its current candidate, marks a window of PRIME_SIEVE_WINDOW odd offsets that
+    some small prime divides, runs Miller-Rabin only on the unmarked ones and moves the residues along by adding
+    2 * PRIME_SIEVE_WINDOW mod p when the window is used up, the candidate is never divided again
+--> rounds <= 0 picks the count for random candidates (error below 2^-80 from 1024 bits up), untrusted input should
+    pass an explicit count such as 40
+--> bases and random starting points come from a per thread xorshift generator, seedPrimeRandom makes runs repeatable,
+    it is not a cryptographic source, keys for real use need a start taken from one
+*/
+#define SMALL_PRIME_LIMIT 8192 //odd primes below this are tried by division before Miller-Rabin
+#define SMALL_PRIME_MAX_COUNT 1027 //odd primes below SMALL_PRIME_LIMIT
+#define PRIME_SIEVE_WINDOW 4096 //odd candidates marked at a time by the generator
+
+typedef struct smallPrimeGroup {
+    limb_t product; //product of count consecutive primes, below BASE
+    short first; //index of the first of them in smallPrimes
+    short count;
+} smallPrimeGroup;
+
+limb_t smallPrimes[SMALL_PRIME_MAX_COUNT];
+smallPrimeGroup smallPrimeGroups[SMALL_PRIME_MAX_COUNT];
+short smallPrimeCount = 0;
+short smallPrimeGroupCount = 0;
+pthread_mutex_t smallPrimesLock = PTHREAD_MUTEX_INITIALIZER;
+__thread uint64_t primeRandomState = 0;
+
+//sieve of Eratosthenes for the table, built once on first use by whichever thread gets there first
+void buildSmallPrimes () {
+    pthread_mutex_lock(&smallPrimesLock);
+    if (smallPrimeGroupCount == 0) {
+        char composite[SMALL_PRIME_LIMIT] = {0};
+        short count = 0;
+        for (int p = 3; p < SMALL_PRIME_LIMIT && count < SMALL_PRIME_MAX_COUNT; p += 2) {
+            if (composite[p]) {
+                continue;
+            }
+            smallPrimes[count++] = p;
+            for (int k = p * p; k < SMALL_PRIME_LIMIT; k += 2 * p) {
+                composite[k] = 1;
+            }
+        }
+
+        short groups = 0;
+        for (short i = 0; i < count; groups++) {
+            dlimb_t product = smallPrimes[i];
+            smallPrimeGroups[groups].first = i;
+            smallPrimeGroups[groups].count = 1;
+            for (i++; i < count && product * smallPrimes[i] <= (dlimb_t)(limb_t)-1; i++) {
+                product *= smallPrimes[i];
+                smallPrimeGroups[groups].count += 1;
+            }
+            smallPrimeGroups[groups].product = (limb_t)product;
+        }
+        smallPrimeCount = count;
+        smallPrimeGroupCount = groups; //written last, a nonzero count means the table is complete
+    }
+    pthread_mutex_unlock(&smallPrimesLock);
+}
+
+//a mod d over the first size limbs of a, a is left alone (limbsDivSmall without the quotient)
+limb_t limbsModSmall (const limb_t* a, short size, limb_t d) {
+    dlimb_t rem = 0;
+
+    for (short i = size - 1; i >= 0; i--) {
+        rem = ((rem << LIMB_BITS) | a[i]) % d;
+    }
+
+    return (limb_t)rem;
+}
+
+//residues[i] = a mod smallPrimes[i], one limbsModSmall pass per group
+void limbsSmallPrimeResidues (limb_t* residues, const limb_t* a, short size) {
+    buildSmallPrimes();
+    for (short g = 0; g < smallPrimeGroupCount; g++) {
+        limb_t rem = limbsModSmall(a, size, smallPrimeGroups[g].product);
+        for (short i = smallPrimeGroups[g].first; i < smallPrimeGroups[g].first + smallPrimeGroups[g].count; i++) {
+            residues[i] = rem % smallPrimes[i];
+        }
+    }
+}
+
+void seedPrimeRandom (uint64_t seed) {
+    primeRandomState = (seed != 0) ? seed : 0x9E3779B97F4A7C15ull;
+}
+
+limb_t primeRandomLimb () {
+    if (primeRandomState == 0) {
+        seedPrimeRandom((uint64_t)time(NULL) ^ ((uint64_t)(uintptr_t)&primeRandomState << 16));
+    }
+    primeRandomState ^= primeRandomState << 13;
+    primeRandomState ^= primeRandomState >> 7;
+    primeRandomState ^= primeRandomState << 17;
+    return (limb_t)(primeRandomState >> 32);
+}
+
+//Miller-Rabin rounds for random candidates of this many bits (Damgard, Landrock and Pomerance bounds, error < 2^-80)
+short millerRabinRounds (int bits) {
+    return (bits >= 1300) ? 2 : (bits >= 850) ? 3 : (bits >= 650) ? 4 : (bits >= 350) ? 8 : (bits >= 250) ? 12
+           : (bits >= 150) ? 18 : 27;
+}
+
+//rounds of Miller-Rabin on the odd a > 3 (n limbs, top limb nonzero), 1 when every round says probably prime,
+//0 for composite and -1 when memory runs out (BIGINT_NO_MEMORY) or a is too wide for Montgomery (BIGINT_OVERFLOW)
+short limbsMillerRabin (const limb_t* a, short n, short rounds) {
+    BigInt m = {(limb_t*)a, POSITIVE, n, n};
+    montgomeryContext ctx;
+    if (!initMontgomery(&ctx, m)) {
+        return -1;
+    }
+    limb_t* block = (limb_t*) malloc(4 * n * sizeof(limb_t));
+    if (block == NULL) {
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        freeMontgomery(&ctx);
+        return -1;
+    }
+    STATS_ALLOC(4 * n * sizeof(limb_t));
+    limb_t* d = block; //odd part of a - 1
+    limb_t* minusOne = d + n; //a - 1 in Montgomery form, that is a - R mod a
+    limb_t* base = minusOne + n;
+    limb_t* y = base + n;
+
+    //a - 1 = d * 2^s
+    memcpy(d, a, n * sizeof(limb_t));
+    d[0] -= 1; //a is odd, no borrow
+    int s = 0;
+    while (d[s / LIMB_BITS] == 0) {
+        s += LIMB_BITS;
+    }
+    s += __builtin_ctz(d[s / LIMB_BITS]);
+    short dn = n - s / LIMB_BITS;
+    memmove(d, d + s / LIMB_BITS, dn * sizeof(limb_t));
+    if (s % LIMB_BITS != 0) {
+        limbsShiftRight(d, d, dn, s % LIMB_BITS);
+    }
+    limbsSub(minusOne, a, n, ctx.one, n);
+
+    short probable = 1;
+    for (short round = 0; round < rounds && probable == 1; round++) {
+        //base 2 first, then random bases below a: random low limbs under a smaller top limb
+        memset(base, 0, n * sizeof(limb_t));
+        if (round == 0) {
+            base[0] = 2;
+        } else {
+            for (short i = 0; i < n - 1; i++) {
+                base[i] = primeRandomLimb();
+            }
+            base[n - 1] = primeRandomLimb() % a[n - 1];
+            if (limbsUsed(base, n) == 0 || (limbsUsed(base, n) == 1 && base[0] < 2)) {
+                base[0] = 2;
+            }
+        }
+
+        if (!montgomeryPower(y, base, d, dn, &ctx)) {
+            probable = -1;
+            break;
+        }
+        //y = base^d, back into Montgomery form for the squarings, 1 or a - 1 passes straight away
+        montgomeryMultiply(y, y, ctx.rSquared, &ctx);
+        if (limbsCompare(y, n, ctx.one, n) == EQUAL || limbsCompare(y, n, minusOne, n) == EQUAL) {
+            continue;
+        }
+        probable = 0;
+        for (int k = 1; k < s; k++) {
+            montgomerySquare(y, y, &ctx);
+            if (limbsCompare(y, n, minusOne, n) == EQUAL) {
+                probable = 1;
+                break;
+            }
+            if (limbsCompare(y, n, ctx.one, n) == EQUAL) {
+                break; //1 without passing through -1: a nontrivial square root of 1
+            }
+        }
+    }
+
+    free(block);
+    freeMontgomery(&ctx);
+    return probable;
+}
+
+//TRUE when n is a probable prime, negative numbers, 0 and 1 are not, rounds <= 0 picks millerRabinRounds
+//below SMALL_PRIME_LIMIT^2 trial division alone decides and the answer is exact
+bool isProbablePrimeBigInt (BigInt n, short rounds) {
+    STATS_BEGIN();
+    short size = n.size;
+    bool prime = FALSE;
+
+    if (n.sign == NEGATIVE || size == 0 || (size == 1 && n.limb_array[0] < 2)) {
+        prime = FALSE;
+    } else if ((n.limb_array[0] & 1) == 0) {
+        prime = (size == 1 && n.limb_array[0] == 2) ? TRUE : FALSE;
+    } else if (size == 1 && n.limb_array[0] < (limb_t)SMALL_PRIME_LIMIT * SMALL_PRIME_LIMIT) {
+        buildSmallPrimes();
+        limb_t value = n.limb_array[0];
+        prime = TRUE;
+        for (short i = 0; i < smallPrimeCount && smallPrimes[i] * smallPrimes[i] <= value; i++) {
+            if (value % smallPrimes[i] == 0) {
+                prime = FALSE;
+                break;
+            }
+        }
+    } else {
+        //bigger than every small prime, so a zero residue always means a proper factor
+        limb_t residues[SMALL_PRIME_MAX_COUNT];
+        limbsSmallPrimeResidues(residues, n.limb_array, size);
+        prime = TRUE;
+        for (short i = 0; i < smallPrimeCount; i++) {
+            if (residues[i] == 0) {
+                prime = FALSE;
+                break;
+            }
+        }
+        if (prime) {
+            int bits = limbsBitLength(n.limb_array, size);
+            prime = (limbsMillerRabin(n.limb_array, size, (rounds > 0) ? rounds : millerRabinRounds(bits)) == 1) ? TRUE : FALSE;
+        }
+    }
+
+    STATS_END(STAT_PRIME);
+    return prime;
+}
+
+//smallest probable prime >= start (2 for anything below that), rounds as for isProbablePrimeBigInt
+//gives 0 with BIGINT_NO_MEMORY raised when memory runs out
+BigInt nextPrimeBigInt (BigInt start, short rounds) {
+    BigInt candidate;
+    short size = (start.sign == NEGATIVE) ? 0 : start.size;
+
+    //small starts just walk the odd numbers, trial division is exact there
+    if (size <= 1 && (size == 0 || start.limb_array[0] < (limb_t)SMALL_PRIME_LIMIT * SMALL_PRIME_LIMIT)) {
+        if (!initializeBigInt(&candidate, 1, POSITIVE)) {
+            return candidate;
+        }
+        limb_t value = (size == 0 || start.limb_array[0] <= 2) ? 2 : (start.limb_array[0] | 1);
+        candidate.limb_array[0] = value;
+        while (!isProbablePrimeBigInt(candidate, rounds)) {
+            value += (value == 2) ? 1 : 2;
+            candidate.limb_array[0] = value;
+        }
+        return candidate;
+    }
+
+    //one spare limb for the carry out of the top while stepping
+    STATS_BEGIN();
+    limb_t* residues = (limb_t*) malloc(SMALL_PRIME_MAX_COUNT * sizeof(limb_t));
+    char* composite = (char*) malloc(PRIME_SIEVE_WINDOW);
+    if (residues == NULL || composite == NULL || !initializeBigInt(&candidate, size + 1, POSITIVE)) {
+        if (residues == NULL || composite == NULL) {
+            raiseBigIntStatus(BIGINT_NO_MEMORY);
+        }
+        free(residues);
+        free(composite);
+        STATS_END(STAT_PRIME);
+        initializeBigInt(&candidate, 0, POSITIVE);
+        return candidate;
+    }
+    STATS_ALLOC(SMALL_PRIME_MAX_COUNT * sizeof(limb_t) + PRIME_SIEVE_WINDOW);
+    memcpy(candidate.limb_array, start.limb_array, size * sizeof(limb_t));
+    candidate.limb_array[0] |= 1;
+    limbsSmallPrimeResidues(residues, candidate.limb_array, size + 1);
+    limb_t* trial = (limb_t*) malloc((size + 1) * sizeof(limb_t));
+    bool found = FALSE;
+    bool failed = (trial == NULL) ? TRUE : FALSE;
+    if (!failed) {
+        STATS_ALLOC((size + 1) * sizeof(limb_t));
+    }
+
+    while (!found && !failed) {
+        //offset j stands for candidate + 2j, p divides it when 2j = -residue mod p, so from j = (p - r) / 2 mod p on
+        memset(composite, 0, PRIME_SIEVE_WINDOW);
+        for (short i = 0; i < smallPrimeCount; i++) {
+            limb_t p = smallPrimes[i];
+            limb_t r = residues[i];
+            limb_t j = (r == 0) ? 0 : ((r & 1) ? (p - r) / 2 : p - r / 2);
+            for (; j < PRIME_SIEVE_WINDOW; j += p) {
+                composite[j] = 1;
+            }
+        }
+
+        for (int j = 0; j < PRIME_SIEVE_WINDOW && !found; j++) {
+            if (composite[j]) {
+                continue;
+            }
+            memcpy(trial, candidate.limb_array, (size + 1) * sizeof(limb_t));
+            limbsAdd(trial, trial, size + 1, (limb_t[]){2 * j}, 1);
+            short trialSize = limbsUsed(trial, size + 1);
+            int bits = limbsBitLength(trial, trialSize);
+            short probable = limbsMillerRabin(trial, trialSize, (rounds > 0) ? rounds : millerRabinRounds(bits));
+            if (probable == 1) {
+                memcpy(candidate.limb_array, trial, (size + 1) * sizeof(limb_t));
+                found = TRUE;
+            } else if (probable < 0) {
+                failed = TRUE;
+                break;
+            }
+        }
+
+        //next window: the candidate moves by 2 * PRIME_SIEVE_WINDOW and so does every residue
+        if (!found && !failed) {
+            limbsAdd(candidate.limb_array, candidate.limb_array, size + 1, (limb_t[]){2 * PRIME_SIEVE_WINDOW}, 1);
+            for (short i = 0; i < smallPrimeCount; i++) {
+                residues[i] = (residues[i] + 2 * PRIME_SIEVE_WINDOW) % smallPrimes[i];
+            }
+        }
+    }
+
+    if (failed) {
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        memset(candidate.limb_array, 0, (size + 1) * sizeof(limb_t));
+    }
+    free(trial);
+    free(residues);
+    free(composite);
+    trimBigInt(&candidate);
+    checkOverflow(candidate.size);
+    STATS_END(STAT_PRIME);
+    return candidate;
+}
+
+//random probable prime of exactly bits bits with the top two bits set, so the product of two has exactly 2 * bits bits
+//bits below 2 raise BIGINT_INVALID_ARGUMENT and give 0
+BigInt randomPrimeBigInt (int bits, short rounds) {
+    BigInt start;
+    if (bits < 2) {
+        raiseBigIntStatus(BIGINT_INVALID_ARGUMENT);
+        initializeBigInt(&start, 0, POSITIVE);
+        return start;
+    }
+    short size = (bits + LIMB_BITS - 1) / LIMB_BITS;
+
+    while (TRUE) {
+        if (!initializeBigInt(&start, size, POSITIVE)) {
+            return start;
+        }
+        for (short i = 0; i < size; i++) {
+            start.limb_array[i] = primeRandomLimb();
+        }
+        int top = (bits - 1) % LIMB_BITS; //bit of the top limb that must be the highest one set
+        start.limb_array[size - 1] &= (limb_t)-1 >> (LIMB_BITS - 1 - top);
+        start.limb_array[size - 1] |= (limb_t)1 << top;
+        if (bits >= 3) {
+            start.limb_array[(bits - 2) / LIMB_BITS] |= (limb_t)1 << ((bits - 2) % LIMB_BITS);
+        }
+
+        BigInt prime = nextPrimeBigInt(start, rounds);
+        freeBigInt(&start);
+        //the walk only leaves the range from the last few thousand numbers below 2^bits, then start over
+        if (prime.size == 0 || bigIntBitLength(prime) == bits) {
+            return prime;
+        }
+        freeBigInt(&prime);
+    }
+}
+
+//prints what the last operation raised (the menu used to get this from inside the arithmetic) and clears the flags
+void reportBigIntStatus () {
+    int status = getBigIntStatus();
+    if (status & BIGINT_OVERFLOW) {
+        fprintf(stderr, "Overflow Warning: result exceeds %d bits.\n", MAX_LIMBS * LIMB_BITS);
+    }
+    if (status & BIGINT_DIVISION_BY_ZERO) {
+        fprintf(stderr, "Error: Division by zero\n");
+    }
+    if (status & BIGINT_NO_MEMORY) {
+        fprintf(stderr, "memory allocation failed.\n");
+    }
+    clearBigIntStatus();
+}
+
+BigInt input_string_1 () {
+    printf("enter first number : ");
+    char* input_string1 = (char*) malloc(sizeof(char) * BIGINT_SIZE);
+    char inputFormat[16];
+    snprintf(inputFormat, sizeof(inputFormat), "%%%ds", BIGINT_SIZE - 1); //reads atmost sign + MAX_DIGITS characters
+    if (input_string1 == NULL) {
+        free(input_string1);
+        fprintf(stderr, "Memory allocation failed is1\n");
+        exit(EXIT_FAILURE);
+    }
+
+    bool validInput = FALSE;
+    while (!validInput) {
+        scanf(inputFormat, input_string1);
+        // Check if input was too long
+        int c;
+        if ((c = getchar()) != '\n' && c != EOF) {
+            // Clear input buffer
+            while ((c = getchar()) != '\n' && c != EOF);
+            printf("Input too long - maximum %d digits allowed.\n", MAX_DIGITS);
+            printf("Please enter a shorter number: ");
+            continue;  // Go back to start of loop for new input
+        }
+        // Check if input format is valid
+        if (!isValidInput(input_string1)) {
+            printf("Please enter valid input: ");
+            continue;  // Go back to start of loop for new input
+        }
+        validInput = TRUE;  // If we get here, input is valid
+    }
+     
+    BigInt b1;
+    printf("first number : ");
+    b1 = readNumFromString(input_string1);
+    printDigits(b1);
+    return b1;
+}
+
+BigInt input_string_2 () {
+    printf("enter second number : ");
+    char* input_string2 = (char*) malloc(sizeof(char) * BIGINT_SIZE);
+    char inputFormat[16];
+    snprintf(inputFormat, sizeof(inputFormat), "%%%ds", BIGINT_SIZE - 1); //reads atmost sign + MAX_DIGITS characters
+    if (input_string2 == NULL) {
+        free(input_string2);
+        fprintf(stderr, "Memory allocation failed is2\n");
+        exit(EXIT_FAILURE);
+    }
+
+    bool validInput = FALSE;
+    while (!validInput) {
+        scanf(inputFormat, input_string2);    
+        // Check if input was too long
+        int c;
+        if ((c = getchar()) != '\n' && c != EOF) {
+            // Clear input buffer
+            while ((c = getchar()) != '\n' && c != EOF);
+            printf("Input too long - maximum %d digits allowed.\n", MAX_DIGITS);
+            printf("Please enter a shorter number: ");
+            continue;
+        }
+
+        // Check if input format is valid
+        if (!isValidInput(input_string2)) {
+            printf("Please enter valid input: ");
+            continue;
+        }
+
+        validInput = TRUE;
+    }
+
+    BigInt b2;
+    printf("second number : ");
+    b2 = readNumFromString(input_string2);
+    printDigits(b2);
+    return b2;
+}
+
+/*
+Batch mode : bigint --batch [file] [--threads n]
+--> reads one operation per line, "op a b", from the file (or stdin when no file is given)
+--> --threads spreads the operations over n worker threads (see evaluateJobs), the output order does not change
+--> op is one of + - * / % (or add sub mul div mod), numbers are decimal with an optional + or - sign
+--> writes only the results, one line per operation in input order, through a fully buffered stdout
+--> a line that cannot be evaluated prints "error" so that results stay lined up with their operations
+*/
+#define BATCH_LINE_SIZE 4096 //longest accepted line, including both operands
+#define BATCH_OUTPUT_BUFFER (1 << 16)
+#define BATCH_CHUNK_LINES 4096 //lines read before the collected jobs are evaluated and printed
+
+typedef enum {OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_INVALID} operation;
+
+operation parseOperation (char* token) {
+    operation op = OP_INVALID;
+
+    if (strcmp(token, "+") == 0 || strcmp(token, "add") == 0) {
+        op = OP_ADD;
+    } else if (strcmp(token, "-") == 0 || strcmp(token, "sub") == 0) {
+        op = OP_SUB;
+    } else if (strcmp(token, "*") == 0 || strcmp(token, "mul") == 0) {
+        op = OP_MUL;
+    } else if (strcmp(token, "/") == 0 || strcmp(token, "div") == 0) {
+        op = OP_DIV;
+    } else if (strcmp(token, "%") == 0 || strcmp(token, "mod") == 0) {
+        op = OP_MOD;
+    }
+
+    return op;
+}
+
+//parses an optionally signed decimal token into b, returns FALSE (and allocates nothing) if it is not a number
+//or if b can not be allocated
+bool readBatchNumber (char* token, BigInt* b) {
+    numSign sign = POSITIVE;
+    char* digits = token;
+
+    if (*digits == '+' || *digits == '-') {
+        sign = (*digits == '-') ? NEGATIVE : POSITIVE;
+        digits += 1;
+    }
+    size_t length = strlen(digits);
+    if (length == 0) {
+        return FALSE;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (digits[i] < '0' || digits[i] > '9') {
+            return FALSE;
+        }
+    }
+
+    STATS_BEGIN();
+    bool parsed = readDecimalDigits(b, digits, (length > DEC_MAX_DIGITS) ? DEC_MAX_DIGITS + 1 : (int)length, sign);
+    STATS_END(STAT_PARSE);
+    return parsed;
+}
+
+BigInt applyOperation (operation op, BigInt a, BigInt b) {
+    BigInt result;
+
+    switch (op) {
+        case OP_ADD : result = addTwoNumbers(a, b); break;
+        case OP_SUB : result = subtracTwotBigInts(a, b); break;
+        case OP_MUL : result = multiplyBigInt(a, b); break;
+        case OP_DIV : result = divideBigInt(a, b); break;
+        case OP_MOD : result = modBigInt(a, b); break;
+        default : initializeBigInt(&result, 0, POSITIVE); break;
+    }
+
+    return result;
+}
+
+/*
+Parallel job evaluator : evaluateJobs(jobs, results, count, threads)
+--> every job is one independent (op, a, b), the jobs are split into one contiguous range per worker
+--> a worker takes JOB_TAKE_CHUNK jobs at a time from the front of its own range, when it runs dry it steals the back
+    half of another worker's range (work stealing), so uneven jobs (a divide next to an add) still keep every core busy
+--> every worker allocates its scratch once and the limb kernels run on it, so the workers never call the allocator
+--> all result limbs live in one block allocated up front, results[i] is written in place so the output stays in job order
+*/
+#define JOB_TAKE_CHUNK 16 //jobs a worker takes from its own queue at a time
+
+typedef struct bigIntJob {
+    operation op;
+    BigInt a;
+    BigInt b;
+} bigIntJob;
+
+typedef struct jobQueue {
+    pthread_mutex_t lock;
+    int head; //owner takes jobs from here
+    int tail; //one past the last job, thieves take jobs from here
+} jobQueue;
+
+typedef struct jobPool {
+    const bigIntJob* jobs;
+    BigInt* results;
+    jobQueue* queues;
+    int workers;
+    int scratchLimbs;
+} jobPool;
+
+typedef struct jobWorker {
+    jobPool* pool;
+    int id;
+    int failed; //jobs that could not be evaluated (division by zero)
+    bool started; //its thread was created, only those are joined
+} jobWorker;
+
+//limbs a job's result can need, the evaluator reserves this much for it
+int jobResultLimbs (const bigIntJob* job) {
+    switch (job -> op) {
+        case OP_ADD : case OP_SUB : return max(job -> a.size, job -> b.size) + 1;
+        case OP_MUL : return job -> a.size + job -> b.size;
+        case OP_DIV : return job -> a.size;
+        case OP_MOD : return job -> b.size;
+        default : return 0;
+    }
+}
+
+//limbs of scratch a worker needs for a job
+int jobScratchLimbs (const bigIntJob* job) {
+    switch (job -> op) {
+        case OP_MUL : return limbsMultiplyScratch(max(job -> a.size, job -> b.size));
+        case OP_DIV : return limbsDivRemScratch(job -> a.size, job -> b.size) + job -> b.size;
+        case OP_MOD : return limbsDivRemScratch(job -> a.size, job -> b.size) + job -> a.size;
+        default : return 0;
+    }
+}
+
+//evaluates one job into the limbs already reserved in result, returns FALSE if it could not be evaluated
+bool runJobKernels (const bigIntJob* job, BigInt* result, limb_t* scratch) {
+    const BigInt* a = &job -> a;
+    const BigInt* b = &job -> b;
+    numSign bSign = b -> sign;
+    if (job -> op == OP_SUB) { //a - b = a + (-b)
+        bSign = (bSign == POSITIVE) ? NEGATIVE : POSITIVE;
+    }
+    result -> sign = POSITIVE;
+    result -> size = 0;
+
+    switch (job -> op) {
+        case OP_SUB :
+        case OP_ADD :
+            result -> size = limbsSignedAdd(result -> limb_array, &result -> sign, a -> limb_array, a -> size, a -> sign, b -> limb_array, b -> size, bSign);
+            return TRUE;
+        case OP_MUL :
+            limbsMultiply(result -> limb_array, a -> limb_array, a -> size, b -> limb_array, b -> size, scratch);
+            result -> size = limbsUsed(result -> limb_array, a -> size + b -> size);
+            result -> sign = (result -> size == 0) ? POSITIVE : (a -> sign ^ b -> sign);
+            return TRUE;
+        case OP_DIV :
+        case OP_MOD : {
+            if (b -> size == 0) {
+                return FALSE;
+            }
+            //the half of the answer that is not wanted goes into scratch after the division's own workspace
+            limb_t* spare = scratch + limbsDivRemScratch(a -> size, b -> size);
+            if (job -> op == OP_DIV) {
+                limbsDivRem(result -> limb_array, spare, a -> limb_array, a -> size, b -> limb_array, b -> size, scratch);
+                result -> size = limbsUsed(result -> limb_array, a -> size);
+                result -> sign = (a -> sign == b -> sign) ? POSITIVE : NEGATIVE;
+            } else {
+                result -> size = limbsDivRem(spare, result -> limb_array, a -> limb_array, a -> size, b -> limb_array, b -> size, scratch);
+                result -> sign = a -> sign;
+            }
+            if (result -> size == 0) {
+                result -> sign = POSITIVE;
+            }
+            return TRUE;
+        }
+        default :
+            return FALSE;
+    }
+}
+
+//the stats counter a batch operation is counted under
+statOperation jobStatOperation (operation op) {
+    switch (op) {
+        case OP_ADD : return STAT_ADD;
+        case OP_SUB : return STAT_SUB;
+        case OP_MUL : return STAT_MUL;
+        default : return STAT_DIVMOD;
+    }
+}
+
+bool runJob (const bigIntJob* job, BigInt* result, limb_t* scratch) {
+    STATS_BEGIN();
+    bool done = runJobKernels(job, result, scratch);
+    STATS_END(jobStatOperation(job -> op));
+    return done;
+}
+
+//moves the next jobs of the worker's own queue, or half of another worker's queue, into [*from, *to), FALSE when no work is left
+bool takeJobs (jobPool* pool, int id, int* from, int* to) {
+    jobQueue* own = &pool -> queues[id];
+
+    pthread_mutex_lock(&own -> lock);
+    if (own -> head < own -> tail) {
+        *from = own -> head;
+        *to = (own -> tail - own -> head > JOB_TAKE_CHUNK) ? own -> head + JOB_TAKE_CHUNK : own -> tail;
+        own -> head = *to;
+        pthread_mutex_unlock(&own -> lock);
+        return TRUE;
+    }
+    pthread_mutex_unlock(&own -> lock);
+
+    for (int k = 1; k < pool -> workers; k++) {
+        jobQueue* victim = &pool -> queues[(id + k) % pool -> workers];
+        int stolenFrom = 0, stolenTo = 0;
+
+        pthread_mutex_lock(&victim -> lock);
+        int remaining = victim -> tail - victim -> head;
+        if (remaining > 0) {
+            stolenTo = victim -> tail;
+            stolenFrom = victim -> tail - (remaining + 1) / 2;
+            victim -> tail = stolenFrom;
+        }
+        pthread_mutex_unlock(&victim -> lock);
+
+        if (stolenTo > stolenFrom) {
+            //the stolen range becomes our own queue, so it can be stolen from again
+            pthread_mutex_lock(&own -> lock);
+            own -> head = stolenFrom;
+            own -> tail = stolenTo;
+            pthread_mutex_unlock(&own -> lock);
+            return takeJobs(pool, id, from, to);
+        }
+    }
+    return FALSE;
+}
+
+void* jobWorkerMain (void* arg) {
+    jobWorker* worker = (jobWorker*) arg;
+    jobPool* pool = worker -> pool;
+    limb_t* scratch = (limb_t*) malloc((pool -> scratchLimbs > 0 ? pool -> scratchLimbs : 1) * sizeof(limb_t));
+    int from, to;
+
+    if (scratch == NULL) { //the other workers steal this one's range, evaluateJobs counts whatever nobody took
+        return NULL;
+    }
+    STATS_ALLOC((pool -> scratchLimbs > 0 ? pool -> scratchLimbs : 1) * sizeof(limb_t));
+    while (takeJobs(pool, worker -> id, &from, &to)) {
+        for (int i = from; i < to; i++) {
+            if (!runJob(&pool -> jobs[i], &pool -> results[i], scratch)) {
+                worker -> failed += 1;
+            }
+        }
+    }
+    free(scratch);
+    return NULL;
+}
+
+//evaluates count jobs on threads workers, results[i] receives the answer to jobs[i]
+//all result limbs share one block, which is returned and must be released with free() once the results are no longer needed
+//*failed (if not NULL) receives the number of jobs that could not be evaluated, their result is zero
+//returns NULL with every job failed and BIGINT_NO_MEMORY raised when the block or the pool can not be allocated
+limb_t* evaluateJobs (const bigIntJob* jobs, BigInt* results, int count, int threads, int* failed) {
+    jobPool pool;
+    long totalLimbs = 1;
+    int scratchLimbs = 0;
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > count) {
+        threads = (count > 0) ? count : 1;
+    }
+    for (int i = 0; i < count; i++) {
+        totalLimbs += jobResultLimbs(&jobs[i]);
+        if (jobScratchLimbs(&jobs[i]) > scratchLimbs) {
+            scratchLimbs = jobScratchLimbs(&jobs[i]);
+        }
+    }
+
+    limb_t* block = (limb_t*) malloc(totalLimbs * sizeof(limb_t));
+    jobQueue* queues = (jobQueue*) malloc(threads * sizeof(jobQueue));
+    jobWorker* workers = (jobWorker*) malloc(threads * sizeof(jobWorker));
+    pthread_t* handles = (pthread_t*) malloc(threads * sizeof(pthread_t));
+    if (block == NULL || queues == NULL || workers == NULL || handles == NULL) {
+        free(block);
+        free(queues);
+        free(workers);
+        free(handles);
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        if (failed != NULL) {
+            *failed = count;
+        }
+        return NULL;
+    }
+    STATS_ALLOC(totalLimbs * sizeof(limb_t));
+    long offset = 0;
+    for (int i = 0; i < count; i++) {
+        results[i].limb_array = block + offset;
+        results[i].size = 0;
+        results[i].capacity = jobResultLimbs(&jobs[i]); //part of block, not a destination for the _into functions
+        results[i].sign = POSITIVE;
+        offset += jobResultLimbs(&jobs[i]);
+    }
+
+    pool.jobs = jobs;
+    pool.results = results;
+    pool.queues = queues;
+    pool.workers = threads;
+    pool.scratchLimbs = scratchLimbs;
+    for (int t = 0; t < threads; t++) {
+        pthread_mutex_init(&queues[t].lock, NULL);
+        queues[t].head = (int)((long)count * t / threads);
+        queues[t].tail = (int)((long)count * (t + 1) / threads);
+        workers[t].pool = &pool;
+        workers[t].id = t;
+        workers[t].failed = 0;
+        workers[t].started = FALSE;
+    }
+
+    //the calling thread is worker 0, the queues of workers whose thread could not be created are stolen from by the others
+    for (int t = 1; t < threads; t++) {
+        workers[t].started = (pthread_create(&handles[t], NULL, jobWorkerMain, &workers[t]) == 0) ? TRUE : FALSE;
+    }
+    jobWorkerMain(&workers[0]);
+    int totalFailed = workers[0].failed;
+    for (int t = 1; t < threads; t++) {
+        if (workers[t].started) {
+            pthread_join(handles[t], NULL);
+            totalFailed += workers[t].failed;
+        }
+    }
+
+    //jobs still queued were left behind by workers that could not get their scratch
+    int untaken = 0;
+    for (int t = 0; t < threads; t++) {
+        untaken += queues[t].tail - queues[t].head;
+        pthread_mutex_destroy(&queues[t].lock);
+    }
+    if (untaken > 0) {
+        raiseBigIntStatus(BIGINT_NO_MEMORY);
+        totalFailed += untaken;
+    }
+    free(queues);
+    free(workers);
+    free(handles);
+    if (failed != NULL) {
+        *failed = totalFailed;
+    }
+    return block;
+}
+
+//lines whose parse failed keep this in place of a job index, so their "error" is printed in order
+#define BATCH_LINE_FAILED -1
+
+//evaluates the jobs collected so far on threads workers, prints every line's result in input order and frees the jobs
+void flushBatch (FILE* out, bigIntJob* jobs, int jobCount, int* lineJob, int lineCount, int threads) {
+    BigInt* results = (BigInt*) malloc((jobCount > 0 ? jobCount : 1) * sizeof(BigInt));
+    if (results == NULL) {
+        printf("memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+    limb_t* block = evaluateJobs(jobs, results, jobCount, threads, NULL);
+    if (block == NULL) {
+        printf("memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < lineCount; i++) {
+        if (lineJob[i] == BATCH_LINE_FAILED) {
+            fprintf(out, "error\n");
+        } else {
+            fprintDigits(out, results[lineJob[i]]);
+        }
+    }
+    for (int i = 0; i < jobCount; i++) {
+        freeBigInt(&jobs[i].a);
+        freeBigInt(&jobs[i].b);
+    }
+    free(block);
+    free(results);
+}
+
+//evaluates every line of in and writes the results to out, returns the number of lines that failed
+//lines are collected BATCH_CHUNK_LINES at a time and each chunk is evaluated on threads workers
+int runBatch (FILE* in, FILE* out, int threads) {
+    char line[BATCH_LINE_SIZE];
+    long lineNumber = 0;
+    int failed = 0;
+    bigIntJob* jobs = (bigIntJob*) malloc(BATCH_CHUNK_LINES * sizeof(bigIntJob));
+    int* lineJob = (int*) malloc(BATCH_CHUNK_LINES * sizeof(int));
+    int jobCount = 0, lineCount = 0;
+
+    if (jobs == NULL || lineJob == NULL) {
+        printf("memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    while (fgets(line, sizeof(line), in) != NULL) {
+        lineNumber += 1;
+        if (lineCount == BATCH_CHUNK_LINES) {
+            flushBatch(out, jobs, jobCount, lineJob, lineCount, threads);
+            jobCount = 0;
+            lineCount = 0;
+        }
+
+        //a line without its newline (and not the last line) was longer than the buffer, skip the rest of it
+        if (strchr(line, '\n') == NULL && !feof(in)) {
+            int c;
+            while ((c = fgetc(in)) != '\n' && c != EOF);
+            fprintf(stderr, "line %ld: too long\n", lineNumber);
+            lineJob[lineCount++] = BATCH_LINE_FAILED;
+            failed += 1;
+            continue;
+        }
+
+        char* opToken = strtok(line, " \t\r\n");
+        if (opToken == NULL) {
+            continue; //blank line
+        }
+        char* aToken = strtok(NULL, " \t\r\n");
+        char* bToken = strtok(NULL, " \t\r\n");
+        bigIntJob* job = &jobs[jobCount];
+        job -> op = parseOperation(opToken);
+
+        if (job -> op == OP_INVALID || aToken == NULL || bToken == NULL || strtok(NULL, " \t\r\n") != NULL) {
+            fprintf(stderr, "line %ld: expected \"op a b\"\n", lineNumber);
+            lineJob[lineCount++] = BATCH_LINE_FAILED;
+            failed += 1;
+            continue;
+        }
+        if (!readBatchNumber(aToken, &job -> a)) {
+            fprintf(stderr, "line %ld: invalid number\n", lineNumber);
+            lineJob[lineCount++] = BATCH_LINE_FAILED;
+            failed += 1;
+            continue;
+        }
+        if (!readBatchNumber(bToken, &job -> b)) {
+            fprintf(stderr, "line %ld: invalid number\n", lineNumber);
+            lineJob[lineCount++] = BATCH_LINE_FAILED;
+            failed += 1;
+            freeBigInt(&job -> a);
+            continue;
+        }
+        if ((job -> op == OP_DIV || job -> op == OP_MOD) && isBigIntZero(job -> b)) {
+            fprintf(stderr, "line %ld: division by zero\n", lineNumber);
+            lineJob[lineCount++] = BATCH_LINE_FAILED;
+            failed += 1;
+            freeBigInt(&job -> a);
+            freeBigInt(&job -> b);
+            continue;
+        }
+        lineJob[lineCount++] = jobCount++;
+    }
+    flushBatch(out, jobs, jobCount, lineJob, lineCount, threads);
+
+    free(jobs);
+    free(lineJob);
+    fflush(out);
+    return failed;
+}
+
+/*
+Binary files : bigint --pack, --unpack and --map
+--> a file is a 16 byte header followed by count fixed size records, everything little endian:
+        bytes 0-3   "BIGI"
+        bytes 4-5   format version (1)
+        bytes 6-7   width, limbs per record
+        bytes 8-15  count, number of records
+--> a record is width + 1 32 bit words: the first holds the used limbs in its low 16 bits and the sign in its top bit,
+    then come width limbs, least significant first, zero padded, so a 1024 bit number takes 132 bytes
+--> openBigIntFile maps a file and bigIntRecord gives a BigInt that points straight at the mapped limbs, the operations
+    run on the records with no parsing and no copy, only the pages that are touched are read
+--> createBigIntFile maps a new file of count records and storeBigIntRecord writes one, writeBigIntArray stores a whole
+    array of BigInts
+*/
+#define BIGINT_FILE_MAGIC "BIGI"
+#define BIGINT_FILE_VERSION 1
+#define BIGINT_FILE_HEADER 16 //bytes before the first record
+#define BIGINT_RECORD_SIGN 0x80000000u //sign bit in the first word of a record
+#define BIGINT_RECORD_USED 0xFFFFu //used limbs in the first word of a record
+#define PACK_OUTPUT_BUFFER (1 << 20)
+
+typedef struct bigIntFile {
+    unsigned char* base; //the mapping, header included
+    size_t length; //bytes mapped
+    short width; //limbs per record
+    long count; //records in the file
+} bigIntFile;
+
+//bytes of one record of width limbs
+size_t bigIntRecordBytes (short width) {
+    return (size_t)(width + 1) * sizeof(limb_t);
+}
+
+void storeLittle32 (unsigned char* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+uint32_t loadLittle32 (const unsigned char* p) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= (uint32_t)p[i] << (8 * i);
+    }
+    return value;
+}
+
+void storeLittle64 (unsigned char* p, uint64_t value) {
+    storeLittle32(p, (uint32_t)value);
+    storeLittle32(p + 4, (uint32_t)(value >> 32));
+}
+
+uint64_t loadLittle64 (const unsigned char* p) {
+    return (uint64_t)loadLittle32(p) | ((uint64_t)loadLittle32(p + 4) << 32);
+}
+
+void encodeBigIntFileHeader (unsigned char* header, long count, short width) {
+    memcpy(header, BIGINT_FILE_MAGIC, 4);
+    header[4] = BIGINT_FILE_VERSION & 0xFF;
+    header[5] = BIGINT_FILE_VERSION >> 8;
+    header[6] = width & 0xFF;
+    header[7] = (width >> 8) & 0xFF;
+    storeLittle64(header + 8, (uint64_t)count);
+}
+
+//writes x as one record of width limbs, returns FALSE (and writes a zero record) when x needs more than width limbs
+bool encodeBigIntRecord (unsigned char* record, BigInt x, short width) {
+    short used = x.size;
+    if (used > width) {
+        memset(record, 0, bigIntRecordBytes(width));
+        return FALSE;
+    }
+
+    storeLittle32(record, (uint32_t)used | ((used > 0 && x.sign == NEGATIVE) ? BIGINT_RECORD_SIGN : 0));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(record + sizeof(limb_t), x.limb_array, used * sizeof(limb_t));
+#else
+    for (short i = 0; i < used; i++) {
+        storeLittle32(record + (i + 1) * sizeof(limb_t), x.limb_array[i]);
+    }
+#endif
+    memset(record + (used + 1) * sizeof(limb_t), 0, (width - used) * sizeof(limb_t));
+    return TRUE;
+}
+
+void closeBigIntFile (bigIntFile* f) {
+    if (f -> base != NULL) {
+        munmap(f -> base, f -> length);
+    }
+    f -> base = NULL;
+    f -> length = 0;
+    f -> width = 0;
+    f -> count = 0;
+}
+
+//maps path read only and checks its header, returns FALSE (with the reason on stderr) if it is not a valid file
+bool openBigIntFile (bigIntFile* f, const char* path) {
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+    //mapped records are used in place, so their limbs have to be in the host order
+    fprintf(stderr, "%s: mapped records need a little endian host\n", path);
+    return FALSE;
+#endif
+    struct stat info;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        fprintf(stderr, "cannot open %s\n", path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return FALSE;
+    }
+    if ((size_t)info.st_size < BIGINT_FILE_HEADER) {
+        fprintf(stderr, "%s: not a bigint file\n", path);
+        close(fd);
+        return FALSE;
+    }
+
+    f -> length = (size_t)info.st_size;
+    f -> base = (unsigned char*) mmap(NULL, f -> length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); //the mapping keeps the file open
+    if (f -> base == MAP_FAILED) {
+        fprintf(stderr, "cannot map %s\n", path);
+        f -> base = NULL;
+        return FALSE;
+    }
+
+    f -> width = (short)(f -> base[6] | (f -> base[7] << 8));
+    uint64_t count = loadLittle64(f -> base + 8);
+    if (memcmp(f -> base, BIGINT_FILE_MAGIC, 4) != 0 || (f -> base[4] | (f -> base[5] << 8)) != BIGINT_FILE_VERSION
+            || f -> width <= 0 || count > (f -> length - BIGINT_FILE_HEADER) / bigIntRecordBytes(f -> width)) {
+        fprintf(stderr, "%s: not a bigint file (or truncated)\n", path);
+        closeBigIntFile(f);
+        return FALSE;
+    }
+    f -> count = (long)count;
+#ifdef MADV_SEQUENTIAL
+    madvise(f -> base, f -> length, MADV_SEQUENTIAL); //bulk passes read the records front to back
+#endif
+    return TRUE;
+}
+
+//creates (or truncates) path with room for count records of width limbs and maps it for writing, records start as zero
+bool createBigIntFile (bigIntFile* f, const char* path, long count, short width) {
+    size_t length = BIGINT_FILE_HEADER + (size_t)count * bigIntRecordBytes(width);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "cannot create %s\n", path);
+        return FALSE;
+    }
+    if (ftruncate(fd, (off_t)length) != 0) {
+        fprintf(stderr, "cannot grow %s to %zu bytes\n", path, length);
+        close(fd);
+        return FALSE;
+    }
+
+    f -> base = (unsigned char*) mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (f -> base == MAP_FAILED) {
+        fprintf(stderr, "cannot map %s\n", path);
+        f -> base = NULL;
+        return FALSE;
+    }
+    f -> length = length;
+    f -> width = width;
+    f -> count = count;
+    encodeBigIntFileHeader(f -> base, count, width);
+    return TRUE;
+}
+
+//record i of a mapped file as a BigInt that points into the mapping
+//it is a view: valid until closeBigIntFile, read only for an opened file, and never passed to freeBigInt
+BigInt bigIntRecord (const bigIntFile* f, long i) {
+    const unsigned char* record = f -> base + BIGINT_FILE_HEADER + (size_t)i * bigIntRecordBytes(f -> width);
+    uint32_t head = loadLittle32(record);
+    BigInt view;
+
+    view.limb_array = (limb_t*)(record + sizeof(limb_t));
+    view.size = (short)(head & BIGINT_RECORD_USED);
+    if (view.size > f -> width) {
+        view.size = f -> width; //a damaged record, its limbs are still all inside the mapping
+    }
+    view.sign = (head & BIGINT_RECORD_SIGN) ? NEGATIVE : POSITIVE;
+    view.capacity = 0; //not owned
+    trimBigInt(&view); //only the view's own size and sign change, the mapping is never written
+    return view;
+}
+
+//stores x as record i of a file made by createBigIntFile, returns FALSE if x needs more than width limbs
+bool storeBigIntRecord (bigIntFile* f, long i, BigInt x) {
+    return encodeBigIntRecord(f -> base + BIGINT_FILE_HEADER + (size_t)i * bigIntRecordBytes(f -> width), x, f -> width);
+}
+
+//writes values[0 .. count) to path as records of width limbs, returns FALSE if the file cannot be written or a value
+//needs more than width limbs (that record is stored as zero)
+bool writeBigIntArray (const char* path, const BigInt* values, long count, short width) {
+    bigIntFile f;
+    bool fits = TRUE;
+
+    if (!createBigIntFile(&f, path, count, width)) {
+        return FALSE;
+    }
+    for (long i = 0; i < count; i++) {
+        if (!storeBigIntRecord(&f, i, values[i])) {
+            fprintf(stderr, "%s: value %ld does not fit in %d limbs\n", path, i, width);
+            fits = FALSE;
+        }
+    }
+    closeBigIntFile(&f);
+    return fits;
+}
+
+//converts decimal lines (one number per line, same syntax as --batch) from in to a file of width limb records
+//records are streamed through stdio and the count is patched into the header at the end, returns the failed lines
+//or -1 if the file cannot be written, a failed line is stored as zero so record numbers still match line numbers
+long packDecimalFile (FILE* in, const char* outPath, short width) {
+    char line[BATCH_LINE_SIZE];
+    unsigned char header[BIGINT_FILE_HEADER];
+    unsigned char* record = (unsigned char*) malloc(bigIntRecordBytes(width));
+    long count = 0, failed = 0;
+    FILE* out = fopen(outPath, "wb");
+
+    if (record == NULL) {
+        printf("memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (out == NULL) {
+        fprintf(stderr, "cannot create %s\n", outPath);
+        free(record);
+        return -1;
+    }
+    setvbuf(out, NULL, _IOFBF, PACK_OUTPUT_BUFFER);
+    encodeBigIntFileHeader(header, 0, width);
+    bool written = fwrite(header, 1, BIGINT_FILE_HEADER, out) == BIGINT_FILE_HEADER;
+
+    while (written && fgets(line, sizeof(line), in) != NULL) {
+        //a line without its newline (and not the last line) was longer than the buffer, skip the rest of it
+        if (strchr(line, '\n') == NULL && !feof(in)) {
+            int c;
+            while ((c = fgetc(in)) != '\n' && c != EOF);
+            count += 1;
+            fprintf(stderr, "line %ld: too long\n", count);
+            memset(record, 0, bigIntRecordBytes(width));
+            failed += 1;
+            written = fwrite(record, 1, bigIntRecordBytes(width), out) == bigIntRecordBytes(width);
+            continue;
+        }
+
+        char* token = strtok(line, " \t\r\n");
+        if (token == NULL) {
+            continue; //blank line
+        }
+        count += 1;
+
+        BigInt x;
+        if (!readBatchNumber(token, &x)) {
+            fprintf(stderr, "line %ld: invalid number\n", count);
+            memset(record, 0, bigIntRecordBytes(width));
+            failed += 1;
+        } else {
+            if (!encodeBigIntRecord(record, x, width)) {
+                fprintf(stderr, "line %ld: does not fit in %d limbs\n", count, width);
+                failed += 1;
+            }
+            freeBigInt(&x);
+        }
+        written = fwrite(record, 1, bigIntRecordBytes(width), out) == bigIntRecordBytes(width);
+    }
+    free(record);
+
+    //a short record write (full disk) stops the loop, the header would otherwise promise records that are not there
+    encodeBigIntFileHeader(header, count, width);
+    if (!written || fseek(out, 0, SEEK_SET) != 0 || fwrite(header, 1, BIGINT_FILE_HEADER, out) != BIGINT_FILE_HEADER) {
+        fprintf(stderr, "cannot write %s\n", outPath);
+        fclose(out);
+        return -1;
+    }
+    if (fclose(out) != 0) {
+        fprintf(stderr, "cannot write %s\n", outPath);
+        return -1;
+    }
+    return failed;
+}
+
+//prints every record of path as a decimal line, straight from the mapping, returns FALSE if the file cannot be opened
+bool unpackBigIntFile (FILE* out, const char* path) {
+    bigIntFile f;
+    if (!openBigIntFile(&f, path)) {
+        return FALSE;
+    }
+    for (long i = 0; i < f.count; i++) {
+        BigInt x = bigIntRecord(&f, i);
+        fprintLimbs(out, x.limb_array, x.size, x.sign);
+    }
+    closeBigIntFile(&f);
+    fflush(out);
+    return TRUE;
+}
+
+//out[i] = a[i] op b[i] over two mapped files with the same count, written to a new mapped file
+//the result width always fits the operation (one more limb than the wider operand for + and -, the sum for *), and the
+//destination BigInt is reused through the _into api, so after the first records the loop neither parses nor allocates
+//returns the failed records (division by zero, stored as zero) or -1 if a file cannot be used
+long runMappedOperation (operation op, const char* aPath, const char* bPath, const char* outPath) {
+    bigIntFile a, b, out;
+    long failed = 0;
+
+    if (!openBigIntFile(&a, aPath)) {
+        return -1;
+    }
+    if (!openBigIntFile(&b, bPath)) {
+        closeBigIntFile(&a);
+        return -1;
+    }
+    if (a.count != b.count) {
+        fprintf(stderr, "%s has %ld records, %s has %ld\n", aPath, a.count, bPath, b.count);
+        closeBigIntFile(&a);
+        closeBigIntFile(&b);
+        return -1;
+    }
+
+    long width; //long, the sum of two widths is past a short for *
+    switch (op) {
+        case OP_ADD :
+        case OP_SUB : width = max(a.width, b.width) + 1L; break;
+        case OP_MUL : width = (long)a.width + b.width; break;
+        case OP_DIV : width = a.width; break;
+        default : width = b.width; break;
+    }
+    if (width > SHRT_MAX) {
+        fprintf(stderr, "results of %s and %s need %ld limbs, records hold atmost %d\n", aPath, bPath, width, SHRT_MAX);
+        closeBigIntFile(&a);
+        closeBigIntFile(&b);
+        return -1;
+    }
+    if (!createBigIntFile(&out, outPath, a.count, (short)width)) {
+        closeBigIntFile(&a);
+        closeBigIntFile(&b);
+        return -1;
+    }
+
+    BigInt result = {0};
+    for (long i = 0; i < a.count; i++) {
+        BigInt x = bigIntRecord(&a, i);
+        BigInt y = bigIntRecord(&b, i);
+        bool done;
+
+        clearBigIntStatus(); //the record width is the limit here and every result fits it, so overflow flags are noise
+        switch (op) {
+            case OP_ADD : done = addBigIntInto(&result, x, y); break;
+            case OP_SUB : done = subtractBigIntInto(&result, x, y); break;
+            case OP_MUL : done = multiplyBigIntInto(&result, x, y); break;
+            default : done = divmodBigIntInto((op == OP_DIV) ? &result : NULL, (op == OP_MOD) ? &result : NULL, x, y); break;
+        }
+        if (!done) {
+            fprintf(stderr, "record %ld: %s\n", i, bigIntStatusMessage(getBigIntStatus()));
+            failed += 1;
+            continue; //the record stays zero
+        }
+        storeBigIntRecord(&out, i, result);
+    }
+
+    freeBigInt(&result);
+    freeWorkspace();
+    closeBigIntFile(&a);
+    closeBigIntFile(&b);
+    closeBigIntFile(&out);
+    return failed;
+}
+
+/*
+Benchmark mode : bigint --bench and bigint --tune [header]
+--> --bench times add, sub, schoolbook multiply, karatsuba multiply, square and divide over a sweep of operand sizes
+--> every timing sample runs a batch of operations (single operations are too short for the clock), the per
+    operation latency of the samples gives p50 / p99 and the total gives throughput
+--> --tune finds the smallest size where one level of Karatsuba over schoolbook leaves beats plain schoolbook on this
+    machine, then the same way the size where one level of Toom-3 beats Karatsuba and where the NTT beats both
+--> before anything is written every tier is checked against limbsKaratsuba on random operands, the thresholds are
+    applied and written to a header (bigint_tuned.h by default) so a build with -DBIGINT_TUNED picks them up
+*/
+#define BENCH_SAMPLES 200 //timing samples per operation and size
+#define BENCH_SAMPLE_NS 20000.0 //each sample runs enough operations to last about this long
+#define TUNE_MAX_LIMBS 160 //largest size tried by --tune
+#define TUNE_CONFIRM 3 //karatsuba has to win this many sizes in a row to count as the crossover
+#define TUNE_TOOM3_MAX_LIMBS 1200 //largest size tried for the Toom-3 crossover
+#define TUNE_NTT_MIN_LIMBS 1000 //the NTT sweep starts here, below it the transform never wins
+#define TUNE_NTT_MAX_LIMBS 16000 //largest size tried for the NTT crossover
+#define TUNE_VALIDATE_ROUNDS 12 //random products per tier checked before the header is written
+
+typedef enum {BENCH_ADD, BENCH_SUB, BENCH_SCHOOLBOOK, BENCH_KARATSUBA, BENCH_SQUARE, BENCH_DIVIDE, BENCH_OP_COUNT} benchOperation;
+
+const char* benchOperationNames[BENCH_OP_COUNT] = {"add", "sub", "mul_schoolbook", "mul_karatsuba", "square", "divide"};
+
+double nowNanoseconds () {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//xorshift, the benchmark only needs cheap reproducible limbs
+limb_t benchRandomLimb (uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (limb_t)(*state >> 16);
+}
+
+//a positive BigInt of exactly size limbs (top limb non zero)
+BigInt benchRandomBigInt (short size, uint64_t* state) {
+    BigInt b;
+    initializeBigInt(&b, size, POSITIVE);
+    for (short i = 0; i < size; i++) {
+        b.limb_array[i] = benchRandomLimb(state);
+    }
+    b.limb_array[size - 1] |= 1;
+    return b;
+}
+
+void benchRunOnce (benchOperation op, BigInt a, BigInt b, BigInt wide) {
+    BigInt result;
+
+    switch (op) {
+        case BENCH_ADD : result = addTwoNumbers(a, b); break;
+        case BENCH_SUB : result = subtracTwotBigInts(a, b); break;
+        case BENCH_SCHOOLBOOK : result = multiplyTwoBigInt(a, b); break;
+        case BENCH_KARATSUBA : result = karatsubaMultiply(a, b); break;
+        case BENCH_SQUARE : result = squareBigInt(a); break;
+        default : result = divideBigInt(wide, b); break; //2n limb dividend by n limb divisor
+    }
+    freeBigInt(&result);
+}
+
+int compareDoubles (const void* x, const void* y) {
+    double a = *(const double*)x, b = *(const double*)y;
+    return (a > b) - (a < b);
+}
+
+//times one operation at one size and prints a table row
+void benchOperationAtSize (FILE* out, benchOperation op, short size, uint64_t* state) {
+    BigInt a = benchRandomBigInt(size, state);
+    BigInt b = benchRandomBigInt(size, state);
+    BigInt wide = benchRandomBigInt(2 * size, state);
+    double samples[BENCH_SAMPLES];
+    double total = 0;
+    long reps = 1;
+
+    //calibrate how many operations make one sample, this also warms up caches and the allocator
+    for (;;) {
+        double start = nowNanoseconds();
+        for (long r = 0; r < reps; r++) {
+            benchRunOnce(op, a, b, wide);
+        }
+        if (nowNanoseconds() - start >= BENCH_SAMPLE_NS || reps >= (1L << 24)) {
+            break;
+        }
+        reps *= 2;
+    }
+
+    for (int s = 0; s < BENCH_SAMPLES; s++) {
+        double start = nowNanoseconds();
+        for (long r = 0; r < reps; r++) {
+            benchRunOnce(op, a, b, wide);
+        }
+        double elapsed = nowNanoseconds() - start;
+        samples[s] = elapsed / reps;
+        total += elapsed;
+    }
+    qsort(samples, BENCH_SAMPLES, sizeof(double), compareDoubles);
+
+    fprintf(out, "%-16s %6d %6d %14.0f %12.1f %12.1f\n", benchOperationNames[op], size, size * LIMB_BITS,
+            (BENCH_SAMPLES * reps) / (total / 1e9), samples[BENCH_SAMPLES / 2], samples[(BENCH_SAMPLES * 99) / 100]);
+
+    freeBigInt(&a);
+    freeBigInt(&b);
+    freeBigInt(&wide);
+}
+
+void runBenchmarks (FILE* out) {
+    short sizes[] = {1, 2, 4, 8, 16, 32, 64, 128, 256};
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    //the sweep goes past 1024 bits on purpose, the overflow flags it raises are never looked at
+    fprintf(out, "karatsuba threshold : %d limbs, limb kernels : %s\n", karatsubaThreshold, limbKernelName);
+    fprintf(out, "%-16s %6s %6s %14s %12s %12s\n", "operation", "limbs", "bits", "ops/sec", "p50 ns", "p99 ns");
+    for (int op = 0; op < BENCH_OP_COUNT; op++) {
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            benchOperationAtSize(out, (benchOperation)op, sizes[i], &state);
+        }
+    }
+    fflush(out);
+}
+
+//best of several runs of one n x n limb multiply at the current thresholds, in nanoseconds
+//through limbsKaratsuba, or through the whole limbsMultiply dispatcher when dispatch is TRUE
+double tuneTimeMultiply (limb_t* r, const limb_t* a, const limb_t* b, short n, limb_t* scratch, bool dispatch) {
+    double best = 0;
+    long reps = 1;
+
+    for (;;) {
+        double start = nowNanoseconds();
+        for (long i = 0; i < reps; i++) {
+            if (dispatch) {
+                limbsMultiply(r, a, n, b, n, scratch);
+            } else {
+                limbsKaratsuba(r, a, b, n, scratch);
+            }
+        }
+        if (nowNanoseconds() - start >= BENCH_SAMPLE_NS) {
+            break;
+        }
+        reps *= 2;
+    }
+    for (int s = 0; s < 15; s++) {
+        double start = nowNanoseconds();
+        for (long i = 0; i < reps; i++) {
+            if (dispatch) {
+                limbsMultiply(r, a, n, b, n, scratch);
+            } else {
+                limbsKaratsuba(r, a, b, n, scratch);
+            }
+        }
+        double perOp = (nowNanoseconds() - start) / reps;
+        if (s == 0 || perOp < best) {
+            best = perOp;
+        }
+    }
+    return best;
+}
+
+//measures the schoolbook / karatsuba crossover and applies it
+short tuneKaratsubaThreshold (FILE* out) {
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    limb_t a[TUNE_MAX_LIMBS], b[TUNE_MAX_LIMBS], r[2 * TUNE_MAX_LIMBS];
+    limb_t* scratch = (limb_t*) malloc(4 * (TUNE_MAX_LIMBS + 2) * sizeof(limb_t));
+    short crossover = TUNE_MAX_LIMBS;
+    short wins = 0;
+
+    if (scratch == NULL) {
+        printf("memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (short i = 0; i < TUNE_MAX_LIMBS; i++) {
+        a[i] = benchRandomLimb(&state);
+        b[i] = benchRandomLimb(&state);
+    }
+
+    fprintf(out, "%6s %14s %14s\n", "limbs", "schoolbook ns", "karatsuba ns");
+    for (short n = KARATSUBA_MIN_THRESHOLD + 1; n <= TUNE_MAX_LIMBS; n++) {
+        //threshold n makes limbsKaratsuba a plain schoolbook multiply, threshold n - 1 splits exactly once
+        setKaratsubaThreshold(n);
+        double schoolbook = tuneTimeMultiply(r, a, b, n, scratch, FALSE);
+        setKaratsubaThreshold(n - 1);
+        double karatsuba = tuneTimeMultiply(r, a, b, n, scratch, FALSE);
+        fprintf(out, "%6d %14.1f %14.1f\n", n, schoolbook, karatsuba);
+
+        wins = (karatsuba < schoolbook) ? wins + 1 : 0;
+        if (wins == TUNE_CONFIRM) {
+            crossover = n - TUNE_CONFIRM + 1;
+            break;
+        }
+    }
+    free(scratch);
+
+    //operands up to one limb below the crossover stay on schoolbook
+    setKaratsubaThreshold(crossover - 1);
+    fprintf(out, "karatsuba threshold : %d limbs\n", karatsubaThreshold);
+    return karatsubaThreshold;
+}
+
+//measures the crossover of one tier above the ones already tuned: at each size the dispatcher runs once with the
+//tier switched off and once with it used for the top level only, setTier picks which threshold is being moved
+//sizes grow by an eighth per step, the sweeps go far past the karatsuba one and single limb steps would take minutes
+short tuneTierThreshold (FILE* out, const char* name, void (*setTier)(short), short from, short to) {
+    uint64_t state = 0x2545F4914F6CDD1Dull;
+    limb_t* a = (limb_t*) malloc(to * sizeof(limb_t));
+    limb_t* b = (limb_t*) malloc(to * sizeof(limb_t));
+    limb_t* r = (limb_t*) malloc(2 * to * sizeof(limb_t));
+    limb_t* scratch;
+    short crossover = to;
+    short wins = 0;
+
+    //the scratch has to cover the largest size both with the tier off and with it used as low as it can go
+    setTier(SHRT_MAX);
+    int scratchSize = limbsMultiplyScratch(to);
+    setTier(TOOM3_MIN_THRESHOLD);
+    if (limbsMultiplyScratch(to) > scratchSize) {
+        scratchSize = limbsMultiplyScratch(to);
+    }
+    scratch = (limb_t*) malloc((scratchSize + 1) * sizeof(limb_t));
+    if (a == NULL || b == NULL || r == NULL || scratch == NULL) {
+        printf("memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (short i = 0; i < to; i++) {
+        a[i] = benchRandomLimb(&state);
+        b[i] = benchRandomLimb(&state);
+    }
+
+    fprintf(out, "%6s %14s %14s\n", "limbs", "below ns", name);
+    for (short n = from; n <= to; n += max(n / 8, 1)) {
+        setTier(SHRT_MAX);
+        double below = tuneTimeMultiply(r, a, b, n, scratch, TRUE);
+        setTier(n - 1);
+        double tier = tuneTimeMultiply(r, a, b, n, scratch, TRUE);
+        fprintf(out, "%6d %14.1f %14.1f\n", n, below, tier);
+
+        wins = (tier < below) ? wins + 1 : 0;
+        if (wins == 1) {
+            crossover = n;
+        }
+        if (wins == TUNE_CONFIRM) {
+            break;
+        }
+    }
+    if (wins < TUNE_CONFIRM) {
+        crossover = to;
+    }
+    free(a);
+    free(b);
+    free(r);
+    free(scratch);
+
+    setTier(crossover - 1);
+    return crossover - 1;
+}
+
+//every tier against limbsKaratsuba on random operands, balanced, unbalanced and all ones, returns the failures
+//the thresholds are pushed down so that the sizes below reach Toom-3 and the NTT, then put back
+int validateMultiplyTiers (FILE* out) {
+    short sizes[] = {TOOM3_MIN_THRESHOLD + 1, 47, 150, 333, 1000, 2500};
+    short keepToom3 = toom3Threshold, keepNtt = nttThreshold;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    int failed = 0;
+
+    for (int tier = 0; tier < 2; tier++) {
+        //tier 0 is Toom-3 all the way down to its minimum, tier 1 the NTT at every size
+        setToom3Threshold(TOOM3_MIN_THRESHOLD);
+        setNttThreshold((tier == 0) ? SHRT_MAX : TOOM3_MIN_THRESHOLD);
+
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            short n = sizes[i];
+            limb_t* a = (limb_t*) malloc(n * sizeof(limb_t));
+            limb_t* b = (limb_t*) malloc(n * sizeof(limb_t));
+            limb_t* expected = (limb_t*) malloc(2 * n * sizeof(limb_t));
+            limb_t* product = (limb_t*) malloc(2 * n * sizeof(limb_t));
+            limb_t* scratch = (limb_t*) malloc((limbsKaratsubaScratch(n) + limbsMultiplyScratch(n) + 1) * sizeof(limb_t));
+            if (a == NULL || b == NULL || expected == NULL || product == NULL || scratch == NULL) {
+                printf("memory allocation failed.\n");
+                exit(EXIT_FAILURE);
+            }
+
+            for (int round = 0; round < TUNE_VALIDATE_ROUNDS; round++) {
+                //b keeps only its low bn limbs, the rest is zero so limbsKaratsuba sees the same value padded
+                short bn = (round % 3 == 0) ? n : (short)(benchRandomLimb(&state) % n) + 1;
+                for (short j = 0; j < n; j++) {
+                    a[j] = (round == 0) ? (limb_t)(BASE - 1) : benchRandomLimb(&state);
+                    b[j] = (j >= bn) ? 0 : (round == 0) ? (limb_t)(BASE - 1) : benchRandomLimb(&state);
+                }
+                limbsKaratsuba(expected, a, b, n, scratch);
+                limbsMultiply(product, a, n, b, bn, scratch);
+                if (memcmp(product, expected, (n + bn) * sizeof(limb_t)) != 0) {
+                    fprintf(out, "%s mismatch at %d x %d limbs\n", (tier == 0) ? "toom3" : "ntt", n, bn);
+                    failed++;
+                }
+            }
+            free(a);
+            free(b);
+            free(expected);
+            free(product);
+            free(scratch);
+        }
+    }
+
+    toom3Threshold = keepToom3;
+    nttThreshold = keepNtt;
+    return failed;
+}
+
+//runs the three crossover measurements, checks the tiers and writes headerPath (NULL to skip the header)
+//returns FALSE when a tier disagrees with karatsuba, nothing is written then
+bool tuneThresholds (FILE* out, const char* headerPath) {
+    tuneKaratsubaThreshold(out);
+    tuneTierThreshold(out, "toom3 ns", setToom3Threshold, max(2 * karatsubaThreshold, TOOM3_MIN_THRESHOLD + 1), TUNE_TOOM3_MAX_LIMBS);
+    fprintf(out, "toom3 threshold : %d limbs\n", toom3Threshold);
+#ifdef NTT_AVAILABLE
+    tuneTierThreshold(out, "ntt ns", setNttThreshold, max(TUNE_NTT_MIN_LIMBS, toom3Threshold + 1), TUNE_NTT_MAX_LIMBS);
+    fprintf(out, "ntt threshold : %d limbs\n", nttThreshold);
+#endif
+
+    int failed = validateMultiplyTiers(out);
+    if (failed > 0) {
+        fprintf(out, "%d products disagree with karatsuba, %s not written\n", failed, (headerPath != NULL) ? headerPath : "header");
+        fflush(out);
+        return FALSE;
+    }
+    fprintf(out, "every tier agrees with karatsuba\n");
+
+    if (headerPath != NULL) {
+        FILE* header = fopen(headerPath, "w");
+        if (header == NULL) {
+            fprintf(stderr, "cannot write %s\n", headerPath);
+        } else {
+            fprintf(header, "/* generated by bigint --tune, build with -DBIGINT_TUNED to use it */\n");
+            fprintf(header, "#define KARATSUBA_THRESHOLD %d\n", karatsubaThreshold);
+            fprintf(header, "#define TOOM3_THRESHOLD %d\n", toom3Threshold);
+            fprintf(header, "#define NTT_THRESHOLD %d\n", nttThreshold);
+            fclose(header);
+            fprintf(out, "written to %s\n", headerPath);
+        }
+    }
+    fflush(out);
+    return TRUE;
+}
+
+/*
+Self test : bigint --selftest
+--> the fast paths are checked against the plain code they replace: the AVX2 limb kernels against the scalar ones,
+    the multiplication tiers and squaring against schoolbook, division against q * b + r, Barrett (own context and
+    cached) against modBigInt, Montgomery exponentiation against square-and-multiply with modBigInt, Lehmer GCD
+    against Euclid, Miller-Rabin against known primes and composites, the fused multiply-accumulate, the aliased _into
+    calls and the accumulator against the allocating functions, the compile time widths against the limb kernels,
+    FixedBigInt against BigInt, evaluateJobs against one job at a time, and the divide-and-conquer conversion against
+    the 9 digit loops
+--> decimal round trips cover the split boundaries and the longest number a short size holds
+--> operands are random (fixed seed, so a failure repeats) or all ones, one line per check, exits with a failure when
+    any of them disagrees
+*/
+#define SELFTEST_ROUNDS 24 //random cases per size
+#define SELFTEST_DECIMAL_REFERENCE 4096 //largest size compared against the quadratic 9 digit loops
+
+//same sign, size and limbs, both have to be canonical
+bool selfTestSame (BigInt a, BigInt b) {
+    return a.sign == b.sign && a.size == b.size && memcmp(a.limb_array, b.limb_array, a.size * sizeof(limb_t)) == 0;
+}
+
+//a random number of exactly size limbs and random sign, all ones when allOnes is TRUE
+BigInt selfTestRandom (short size, bool allOnes, uint64_t* state) {
+    BigInt b = benchRandomBigInt(size, state);
+    if (allOnes) {
+        for (short i = 0; i < size; i++) {
+            b.limb_array[i] = (limb_t)(BASE - 1);
+        }
+    }
+    b.sign = (benchRandomLimb(state) & 1) ? NEGATIVE : POSITIVE;
+    return b;
+}
+
+//a BigInt holding the machine word v
+BigInt selfTestSmall (uint64_t v) {
+    BigInt b;
+    if (initializeBigInt(&b, 2, POSITIVE)) {
+        b.limb_array[0] = (limb_t)v;
+        b.limb_array[1] = (limb_t)(v >> LIMB_BITS);
+        trimBigInt(&b);
+    }
+    return b;
+}
+
+//2^bits - 1
+BigInt selfTestMersenne (int bits) {
+    BigInt b;
+    short size = (bits + LIMB_BITS - 1) / LIMB_BITS;
+    if (initializeBigInt(&b, size, POSITIVE)) {
+        for (short i = 0; i < size; i++) {
+            b.limb_array[i] = (limb_t)(BASE - 1);
+        }
+        if (bits % LIMB_BITS != 0) {
+            b.limb_array[size - 1] >>= LIMB_BITS - bits % LIMB_BITS;
+        }
+    }
+    return b;
+}
+
+//prints the outcome of one check, returns the failures so the caller can add them up
+int selfTestReport (FILE* out, const char* name, int failed) {
+    if (failed == 0) {
+        fprintf(out, "%-14s : ok\n", name);
+    } else {
+        fprintf(out, "%-14s : %d failed\n", name, failed);
     }
+    fflush(out);
+    return failed;
+}
 
-    char sign = (b.sign == POSITIVE) ? '+' : '-';
-    printf("%c", sign);
+//multiplyBigInt, karatsubaMultiply and squareBigInt against schoolbook at sizes reaching every tier at its default
+//threshold, then the parallel split, then every tier forced down to small sizes by validateMultiplyTiers
+int selfTestMultiply (FILE* out) {
+    short sizes[] = {1, 5, 33, 200, 700, 2500, 12000};
+    uint64_t state = 0x5EED0001ull;
+    int failed = 0;
 
-    for (; i < size; i++) {
-        printf("%u", b.digit_array[i]);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short n = sizes[i];
+        short rounds = (n > 1000) ? 2 : SELFTEST_ROUNDS;
+        for (short round = 0; round < rounds; round++) {
+            //round 0 is all ones, odd rounds are unbalanced
+            BigInt x = selfTestRandom(n, round == 0, &state);
+            BigInt y = selfTestRandom((round % 2 == 1) ? (short)(benchRandomLimb(&state) % n) + 1 : n, round == 0, &state);
+            BigInt expected = multiplyTwoBigInt(x, y);
+            BigInt product = multiplyBigInt(x, y);
+            BigInt karatsuba = karatsubaMultiply(x, y);
+            BigInt expectedSquare = multiplyTwoBigInt(x, x);
+            BigInt square = squareBigInt(x);
+            if (!selfTestSame(product, expected) || !selfTestSame(karatsuba, expected)) {
+                fprintf(out, "multiply mismatch at %d x %d limbs\n", x.size, y.size);
+                failed++;
+            }
+            if (!selfTestSame(square, expectedSquare)) {
+                fprintf(out, "square mismatch at %d limbs\n", x.size);
+                failed++;
+            }
+            freeBigInt(&x);
+            freeBigInt(&y);
+            freeBigInt(&expected);
+            freeBigInt(&product);
+            freeBigInt(&karatsuba);
+            freeBigInt(&expectedSquare);
+            freeBigInt(&square);
+        }
+    }
+
+    short keepDepth = parallelMultiplyDepth, keepCutoff = parallelMultiplyCutoff;
+    setParallelMultiply(2, 64);
+    for (short round = 0; round < 4; round++) {
+        BigInt x = selfTestRandom(700, round == 0, &state);
+        BigInt y = selfTestRandom(500 + round * 60, round == 0, &state);
+        BigInt expected = multiplyTwoBigInt(x, y);
+        BigInt product = multiplyBigInt(x, y);
+        if (!selfTestSame(product, expected)) {
+            fprintf(out, "parallel multiply mismatch at %d x %d limbs\n", x.size, y.size);
+            failed++;
+        }
+        freeBigInt(&x);
+        freeBigInt(&y);
+        freeBigInt(&expected);
+        freeBigInt(&product);
     }
+    parallelMultiplyDepth = keepDepth;
+    parallelMultiplyCutoff = keepCutoff;
 
-    printf("\n");
+    return failed + validateMultiplyTiers(out);
 }
 
-BigInt copyBigInt (BigInt b) {
-    BigInt b1;
-    initializeBigInt(&b1, b.size, b.sign);
-    for (int i = 0; i < b.size; i++) {
-        b1.digit_array[i] = b.digit_array[i];
+//base^exponent mod m by square-and-multiply with modBigInt, the reference for modPowBigInt
+BigInt selfTestModPow (BigInt base, BigInt exponent, BigInt m) {
+    BigInt result = selfTestSmall(1);
+    BigInt b = modBigInt(base, m);
+    for (int bit = bigIntBitLength(exponent) - 1; bit >= 0; bit--) {
+        BigInt square = multiplyBigInt(result, result);
+        freeBigInt(&result);
+        result = modBigInt(square, m);
+        freeBigInt(&square);
+        if ((exponent.limb_array[bit / LIMB_BITS] >> (bit % LIMB_BITS)) & 1) {
+            BigInt product = multiplyBigInt(result, b);
+            freeBigInt(&result);
+            result = modBigInt(product, m);
+            freeBigInt(&product);
+        }
     }
-    return b1;
+    freeBigInt(&b);
+    return result;
 }
 
-BigInt input_string_1 () {
-    printf("enter first number : ");
-    char* input_string1 = (char*) malloc(sizeof(char) * BIGINT_SIZE);
-    if (input_string1 == NULL) {
-        free(input_string1);
-        fprintf(stderr, "Memory allocation failed is1\n");
-        exit(EXIT_FAILURE);
+//modPowBigInt for odd (Montgomery) and even (Barrett) moduli against selfTestModPow
+int selfTestModPowTiers (FILE* out) {
+    short sizes[] = {1, 2, 8, 32, 33, 300};
+    uint64_t state = 0x5EED0002ull;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short n = sizes[i];
+        short rounds = (n > 100) ? 4 : SELFTEST_ROUNDS / 2;
+        for (short round = 0; round < rounds; round++) {
+            BigInt m = selfTestRandom(n, round == 0, &state);
+            m.sign = POSITIVE;
+            m.limb_array[0] |= 2; //atleast 2, so the even modulus is never 0
+            if (round % 2 == 1) {
+                m.limb_array[0] &= ~(limb_t)1;
+            } else {
+                m.limb_array[0] |= 1;
+            }
+            BigInt base = selfTestRandom((short)(benchRandomLimb(&state) % (n + 2)) + 1, round == 0, &state);
+            base.sign = POSITIVE;
+            BigInt exponent = selfTestRandom(2, FALSE, &state);
+            exponent.sign = POSITIVE;
+
+            BigInt expected = selfTestModPow(base, exponent, m);
+            BigInt result = modPowBigInt(base, exponent, m);
+            if (!selfTestSame(result, expected)) {
+                fprintf(out, "modpow mismatch, %s modulus of %d limbs\n", (round % 2 == 1) ? "even" : "odd", n);
+                failed++;
+            }
+            freeBigInt(&m);
+            freeBigInt(&base);
+            freeBigInt(&exponent);
+            freeBigInt(&expected);
+            freeBigInt(&result);
+        }
     }
 
-    bool validInput = FALSE;
-    while (!validInput) {
-        scanf("%310s", input_string1);
-        // Check if input was too long
-        int c;
-        if ((c = getchar()) != '\n' && c != EOF) {
-            // Clear input buffer
-            while ((c = getchar()) != '\n' && c != EOF);
-            printf("Input too long - maximum 309 digits allowed.\n");
-            printf("Please enter a shorter number: ");
-            continue;  // Go back to start of loop for new input
+    //above 16383 limbs neither context fits short sizes, both moduli have to be refused with BIGINT_OVERFLOW and 0,
+    //and Miller-Rabin on such a number reports it without a result
+    BigInt wide = selfTestRandom(17000, FALSE, &state);
+    BigInt exponent = selfTestSmall(3);
+    wide.sign = POSITIVE;
+    for (short round = 0; round < 2; round++) {
+        wide.limb_array[0] = (round == 0) ? (wide.limb_array[0] | 1) : (wide.limb_array[0] & ~(limb_t)1);
+        clearBigIntStatus();
+        BigInt result = modPowBigInt(exponent, exponent, wide);
+        if (result.size != 0 || (getBigIntStatus() & BIGINT_OVERFLOW) == 0) {
+            fprintf(out, "modpow with a %s 17000 limb modulus was not refused\n", (round == 0) ? "odd" : "even");
+            failed++;
         }
-        // Check if input format is valid
-        if (!isValidInput(input_string1)) {
-            printf("Please enter valid input: ");
-            continue;  // Go back to start of loop for new input
+        freeBigInt(&result);
+    }
+    wide.limb_array[0] |= 1;
+    clearBigIntStatus();
+    if (limbsMillerRabin(wide.limb_array, wide.size, 1) != -1 || (getBigIntStatus() & BIGINT_OVERFLOW) == 0) {
+        fprintf(out, "miller-rabin on a 17000 limb number was not refused\n");
+        failed++;
+    }
+    freeBigInt(&wide);
+    freeBigInt(&exponent);
+    return failed;
+}
+
+//Lehmer gcdBigInt against Euclid on modBigInt, Bezout coefficients of extendedGcdBigInt and modInverseBigInt
+int selfTestGcd (FILE* out) {
+    short sizes[] = {1, 3, 12, 40, 150};
+    uint64_t state = 0x5EED0003ull;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short n = sizes[i];
+        for (short round = 0; round < SELFTEST_ROUNDS / 2; round++) {
+            //a common factor so the gcd is not almost always 1, odd rounds take very unbalanced operands
+            BigInt common = selfTestRandom((short)(benchRandomLimb(&state) % n) + 1, FALSE, &state);
+            BigInt x = selfTestRandom(n, round == 0, &state);
+            BigInt y = selfTestRandom((round % 2 == 1) ? 1 : n, round == 0, &state);
+            BigInt a = multiplyBigInt(x, common);
+            BigInt b = multiplyBigInt(y, common);
+
+            //Euclid on the magnitudes
+            BigInt p = copyBigInt(a), q = copyBigInt(b);
+            p.sign = POSITIVE;
+            q.sign = POSITIVE;
+            while (q.size != 0) {
+                BigInt r = modBigInt(p, q);
+                freeBigInt(&p);
+                p = q;
+                q = r;
+            }
+
+            BigInt g = gcdBigInt(a, b);
+            BigInt s, t;
+            BigInt h = extendedGcdBigInt(a, b, &s, &t);
+            BigInt as = multiplyBigInt(a, s);
+            BigInt bt = multiplyBigInt(b, t);
+            BigInt sum = addTwoNumbers(as, bt);
+            if (!selfTestSame(g, p) || !selfTestSame(h, p) || !selfTestSame(sum, p)) {
+                fprintf(out, "gcd mismatch at %d x %d limbs\n", a.size, b.size);
+                failed++;
+            }
+            freeBigInt(&common);
+            freeBigInt(&x);
+            freeBigInt(&y);
+            freeBigInt(&a);
+            freeBigInt(&b);
+            freeBigInt(&p);
+            freeBigInt(&q);
+            freeBigInt(&g);
+            freeBigInt(&s);
+            freeBigInt(&t);
+            freeBigInt(&h);
+            freeBigInt(&as);
+            freeBigInt(&bt);
+            freeBigInt(&sum);
         }
-        validInput = TRUE;  // If we get here, input is valid
     }
-     
-    BigInt b1;
-    printf("first number : ");
-    b1 = readNumFromString(input_string1);
-    printDigits(b1);
-    return b1;
+
+    //a * a^-1 = 1 mod the prime 2^127 - 1
+    BigInt m = selfTestMersenne(127);
+    BigInt one = selfTestSmall(1);
+    for (short round = 0; round < SELFTEST_ROUNDS; round++) {
+        BigInt a = selfTestRandom(3, round == 0, &state);
+        a.sign = POSITIVE;
+        BigInt inverse = modInverseBigInt(a, m);
+        BigInt product = multiplyBigInt(a, inverse);
+        BigInt reduced = modBigInt(product, m);
+        if (!selfTestSame(reduced, one)) {
+            fprintf(out, "modular inverse mismatch\n");
+            failed++;
+        }
+        freeBigInt(&a);
+        freeBigInt(&inverse);
+        freeBigInt(&product);
+        freeBigInt(&reduced);
+    }
+    freeBigInt(&m);
+    freeBigInt(&one);
+    return failed;
 }
 
-BigInt input_string_2 () {
-    printf("enter second number : ");
-    char* input_string2 = (char*) malloc(sizeof(char) * BIGINT_SIZE);
-    if (input_string2 == NULL) {
-        free(input_string2);
-        fprintf(stderr, "Memory allocation failed is2\n");
+//the sieve-exact range against a plain sieve, Mersenne primes and composites, strong pseudoprimes and nextPrimeBigInt
+int selfTestPrimes (FILE* out) {
+    int primeExponents[] = {61, 89, 107, 127, 521, 607};
+    int compositeExponents[] = {67, 101, 257};
+    int failed = 0;
+
+    //the primes below 10000, there are 1229
+    int count = 0;
+    for (uint64_t v = 0; v < 10000; v++) {
+        BigInt b = selfTestSmall(v);
+        count += isProbablePrimeBigInt(b, 0) ? 1 : 0;
+        freeBigInt(&b);
+    }
+    if (count != 1229) {
+        fprintf(out, "%d primes below 10000, expected 1229\n", count);
+        failed++;
+    }
+
+    for (size_t i = 0; i < sizeof(primeExponents) / sizeof(primeExponents[0]); i++) {
+        BigInt b = selfTestMersenne(primeExponents[i]);
+        if (!isProbablePrimeBigInt(b, 20)) {
+            fprintf(out, "2^%d - 1 reported composite\n", primeExponents[i]);
+            failed++;
+        }
+        freeBigInt(&b);
+    }
+    for (size_t i = 0; i < sizeof(compositeExponents) / sizeof(compositeExponents[0]); i++) {
+        BigInt b = selfTestMersenne(compositeExponents[i]);
+        if (isProbablePrimeBigInt(b, 20)) {
+            fprintf(out, "2^%d - 1 reported prime\n", compositeExponents[i]);
+            failed++;
+        }
+        freeBigInt(&b);
+    }
+
+    //3215031751 is a strong pseudoprime to the bases 2, 3, 5 and 7, the product of two Mersenne primes has no small factor
+    BigInt pseudoprime = selfTestSmall(3215031751ull);
+    BigInt m61 = selfTestMersenne(61), m89 = selfTestMersenne(89);
+    BigInt product = multiplyBigInt(m61, m89);
+    if (isProbablePrimeBigInt(pseudoprime, 20) || isProbablePrimeBigInt(product, 20)) {
+        fprintf(out, "composite reported prime\n");
+        failed++;
+    }
+
+    //2^89 - 2 is even and 2^89 - 1 is prime, so it is the next prime
+    BigInt one = selfTestSmall(1);
+    BigInt start = subtracTwotBigInts(m89, one);
+    BigInt next = nextPrimeBigInt(start, 20);
+    if (!selfTestSame(next, m89)) {
+        fprintf(out, "next prime after 2^89 - 2 is not 2^89 - 1\n");
+        failed++;
+    }
+    freeBigInt(&pseudoprime);
+    freeBigInt(&m61);
+    freeBigInt(&m89);
+    freeBigInt(&product);
+    freeBigInt(&one);
+    freeBigInt(&start);
+    freeBigInt(&next);
+    return failed;
+}
+
+//addMul, subMul, addMulLimb and dot against multiplyBigInt followed by addTwoNumbers / subtracTwotBigInts
+int selfTestAddMul (FILE* out) {
+    short sizes[] = {1, 2, 7, 30, 100, 400};
+    uint64_t state = 0x5EED0004ull;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short n = sizes[i];
+        for (short round = 0; round < SELFTEST_ROUNDS; round++) {
+            BigInt a = selfTestRandom(n, round == 0, &state);
+            BigInt b = selfTestRandom((short)(benchRandomLimb(&state) % n) + 1, round == 0, &state);
+            BigInt acc = selfTestRandom((short)(benchRandomLimb(&state) % (2 * n)) + 1, round == 0, &state);
+            BigInt product = multiplyBigInt(a, b);
+            BigInt expected = (round % 2 == 0) ? addTwoNumbers(acc, product) : subtracTwotBigInts(acc, product);
+            BigInt result = copyBigInt(acc);
+            bool done = (round % 2 == 0) ? addMulBigIntInto(&result, a, b) : subMulBigIntInto(&result, a, b);
+            if (!done || !selfTestSame(result, expected)) {
+                fprintf(out, "%s mismatch at %d x %d limbs\n", (round % 2 == 0) ? "addmul" : "submul", a.size, b.size);
+                failed++;
+            }
+
+            //single limb multiplier, the low limb of b
+            BigInt m = selfTestSmall(b.limb_array[0]);
+            BigInt limbProduct = multiplyBigInt(a, m);
+            BigInt limbExpected = addTwoNumbers(acc, limbProduct);
+            BigInt limbResult = copyBigInt(acc);
+            if (!addMulLimbBigIntInto(&limbResult, a, b.limb_array[0]) || !selfTestSame(limbResult, limbExpected)) {
+                fprintf(out, "addmul limb mismatch at %d limbs\n", a.size);
+                failed++;
+            }
+
+            //dot over (a, b), (b, acc) and (acc, a)
+            BigInt left[3] = {a, b, acc}, right[3] = {b, acc, a};
+            BigInt dot = {0};
+            BigInt sum = selfTestSmall(0);
+            for (int k = 0; k < 3; k++) {
+                BigInt term = multiplyBigInt(left[k], right[k]);
+                BigInt grown = addTwoNumbers(sum, term);
+                freeBigInt(&sum);
+                freeBigInt(&term);
+                sum = grown;
+            }
+            if (!dotBigIntInto(&dot, left, right, 3) || !selfTestSame(dot, sum)) {
+                fprintf(out, "dot mismatch at %d limbs\n", n);
+                failed++;
+            }
+            freeBigInt(&a);
+            freeBigInt(&b);
+            freeBigInt(&acc);
+            freeBigInt(&product);
+            freeBigInt(&expected);
+            freeBigInt(&result);
+            freeBigInt(&m);
+            freeBigInt(&limbProduct);
+            freeBigInt(&limbExpected);
+            freeBigInt(&limbResult);
+            freeBigInt(&dot);
+            freeBigInt(&sum);
+        }
+    }
+    return failed;
+}
+
+//the deferred-carry accumulator against a running addTwoNumbers sum, read several times along the way
+int selfTestAccumulator (FILE* out) {
+    uint64_t state = 0x5EED0005ull;
+    int failed = 0;
+    bigIntAccumulator acc;
+    BigInt sum = selfTestSmall(0);
+    BigInt value = {0};
+
+    if (!initAccumulator(&acc, 4)) {
+        return selfTestReport(out, "accumulator", 1);
+    }
+    for (int i = 1; i <= 2000; i++) {
+        //mostly short addends, now and then a long one that makes the lanes grow
+        short n = (i % 97 == 0) ? 60 : (short)(benchRandomLimb(&state) % 8) + 1;
+        BigInt x = selfTestRandom(n, i % 50 == 0, &state);
+        BigInt grown = addTwoNumbers(sum, x);
+        freeBigInt(&sum);
+        sum = grown;
+        if (!accumulateBigInt(&acc, x)) {
+            failed++;
+        }
+        freeBigInt(&x);
+        if (i % 250 == 0 && (!accumulatorValueInto(&value, &acc) || !selfTestSame(value, sum))) {
+            fprintf(out, "accumulator mismatch after %d addends\n", i);
+            failed++;
+        }
+    }
+    freeAccumulator(&acc);
+    freeBigInt(&sum);
+    freeBigInt(&value);
+    return failed;
+}
+
+//a positive number of exactly size limbs, every limb one of 0, 1, 2^31 - 1, 2^31 and 2^32 - 1 (the top one non zero)
+//quotient estimates of the long division miss far more often on these than on random limbs
+BigInt selfTestEdges (short size, uint64_t* state) {
+    static const limb_t edges[] = {0, 1, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu};
+    BigInt b = benchRandomBigInt(size, state);
+    for (short i = 0; i < size; i++) {
+        b.limb_array[i] = edges[benchRandomLimb(state) % 5];
+    }
+    if (b.limb_array[size - 1] == 0) {
+        b.limb_array[size - 1] = 0x80000000u;
+    }
+    return b;
+}
+
+//divmodBigInt, divideBigInt, modBigInt and divmodBigIntInto against the definition of truncated division:
+//a = q * b + r (schoolbook product) with |r| < |b|, r has the sign of a and q the sign of a * b
+int selfTestDivide (FILE* out) {
+    short sizes[] = {1, 2, 3, 10, 50, 300};
+    uint64_t state = 0x5EED0007ull;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short n = sizes[i];
+        for (short round = 0; round < SELFTEST_ROUNDS; round++) {
+            //round 0 is all ones, every third round uses edge limbs, every fourth a single limb divisor
+            short bn = (round % 4 == 3) ? 1 : (short)(benchRandomLimb(&state) % n) + 1;
+            BigInt a = (round % 3 == 2) ? selfTestEdges(n, &state) : selfTestRandom(n, round == 0, &state);
+            BigInt b = (round % 3 == 2) ? selfTestEdges(bn, &state) : selfTestRandom(bn, round == 0, &state);
+            a.sign = (round & 1) ? NEGATIVE : POSITIVE;
+            b.sign = (round & 2) ? NEGATIVE : POSITIVE;
+            BigInt q, r, qInto = {0}, rInto = {0};
+            divmodBigInt(a, b, &q, &r);
+            BigInt product = multiplyTwoBigInt(q, b);
+            BigInt back = addTwoNumbers(product, r);
+            BigInt quotient = divideBigInt(a, b);
+            BigInt remainder = modBigInt(a, b);
+            numSign qSign = (a.sign == b.sign) ? POSITIVE : NEGATIVE;
+            if (!selfTestSame(back, a) || compareMagnitude(r, b) != SMALL || (r.size != 0 && r.sign != a.sign) ||
+                (q.size != 0 && q.sign != qSign)) {
+                fprintf(out, "divmod wrong at %d / %d limbs\n", a.size, b.size);
+                failed++;
+            }
+            if (!selfTestSame(quotient, q) || !selfTestSame(remainder, r) || !divmodBigIntInto(&qInto, &rInto, a, b) ||
+                !selfTestSame(qInto, q) || !selfTestSame(rInto, r)) {
+                fprintf(out, "division entry points disagree at %d / %d limbs\n", a.size, b.size);
+                failed++;
+            }
+            freeBigInt(&a);
+            freeBigInt(&b);
+            freeBigInt(&q);
+            freeBigInt(&r);
+            freeBigInt(&product);
+            freeBigInt(&back);
+            freeBigInt(&quotient);
+            freeBigInt(&remainder);
+            freeBigInt(&qInto);
+            freeBigInt(&rInto);
+        }
+    }
+    return failed;
+}
+
+//barrettReduceBigInt through its own context and modBigIntCached against modBigInt, on both sides of
+//BARRETT_FULL_PRODUCT_LIMBS, with more moduli than the cache holds and past BARRETT_MAX_LIMBS
+int selfTestBarrett (FILE* out) {
+    short sizes[] = {1, 2, 5, 40, BARRETT_FULL_PRODUCT_LIMBS - 1, BARRETT_FULL_PRODUCT_LIMBS, 300};
+    uint64_t state = 0x5EED0008ull;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short k = sizes[i];
+        short rounds = (k > 100) ? 4 : SELFTEST_ROUNDS / 2;
+        for (short round = 0; round < rounds; round++) {
+            //x runs from shorter than m up to three times its length, round 0 is all ones, every third round edge limbs
+            short xn = (short)(benchRandomLimb(&state) % (3 * k)) + 1;
+            BigInt m = (round % 3 == 2) ? selfTestEdges(k, &state) : selfTestRandom(k, round == 0, &state);
+            BigInt x = (round % 3 == 2) ? selfTestEdges(xn, &state) : selfTestRandom(xn, round == 0, &state);
+            BigInt expected = modBigInt(x, m);
+            barrettContext ctx;
+            if (!initBarrett(&ctx, m)) {
+                fprintf(out, "barrett context failed at %d limbs\n", k);
+                failed++;
+            } else {
+                BigInt reduced = barrettReduceBigInt(x, &ctx);
+                BigInt cached = modBigIntCached(x, m);
+                if (!selfTestSame(reduced, expected) || !selfTestSame(cached, expected)) {
+                    fprintf(out, "barrett mismatch at %d mod %d limbs\n", x.size, k);
+                    failed++;
+                }
+                freeBarrett(&ctx);
+                freeBigInt(&reduced);
+                freeBigInt(&cached);
+            }
+            freeBigInt(&m);
+            freeBigInt(&x);
+            freeBigInt(&expected);
+        }
+    }
+
+    //twice round more moduli than the cache keeps, every lookup after the first pass replaces an entry
+    BigInt moduli[BARRETT_CACHE_SIZE + 3];
+    for (int i = 0; i < BARRETT_CACHE_SIZE + 3; i++) {
+        moduli[i] = selfTestRandom((short)(i % 4) + 2, FALSE, &state);
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < BARRETT_CACHE_SIZE + 3; i++) {
+            BigInt x = selfTestRandom(12, FALSE, &state);
+            BigInt expected = modBigInt(x, moduli[i]);
+            BigInt cached = modBigIntCached(x, moduli[i]);
+            if (!selfTestSame(cached, expected)) {
+                fprintf(out, "barrett cache mismatch on modulus %d, pass %d\n", i, pass);
+                failed++;
+            }
+            freeBigInt(&x);
+            freeBigInt(&expected);
+            freeBigInt(&cached);
+        }
+    }
+    for (int i = 0; i < BARRETT_CACHE_SIZE + 3; i++) {
+        freeBigInt(&moduli[i]);
+    }
+
+    //too wide for a context, modBigIntCached has to hand it to modBigInt
+    BigInt m = selfTestRandom(BARRETT_MAX_LIMBS + 1, FALSE, &state);
+    BigInt x = selfTestRandom(BARRETT_MAX_LIMBS + 3000, FALSE, &state);
+    BigInt expected = modBigInt(x, m);
+    BigInt cached = modBigIntCached(x, m);
+    if (!selfTestSame(cached, expected)) {
+        fprintf(out, "modBigIntCached wrong past BARRETT_MAX_LIMBS\n");
+        failed++;
+    }
+    freeBigInt(&m);
+    freeBigInt(&x);
+    freeBigInt(&expected);
+    freeBigInt(&cached);
+    return failed;
+}
+
+//the _into functions with the destination being one of the inputs, against the allocating versions, once with a
+//destination that has to grow and once with one big enough to be reused in place
+int selfTestInto (FILE* out) {
+    short sizes[] = {1, 3, 20, 100};
+    uint64_t state = 0x5EED0009ull;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short n = sizes[i];
+        for (short round = 0; round < SELFTEST_ROUNDS / 2; round++) {
+            BigInt a = selfTestRandom(n, round == 0, &state);
+            BigInt b = selfTestRandom((short)(benchRandomLimb(&state) % (2 * n)) + 1, round == 0, &state);
+            BigInt sum = addTwoNumbers(a, b);
+            BigInt difference = subtracTwotBigInts(a, b);
+            BigInt product = multiplyBigInt(a, b);
+            BigInt square = multiplyBigInt(a, a);
+            BigInt q, r;
+            divmodBigInt(a, b, &q, &r);
+
+            //odd rounds first fill the destinations with a long number, so their limbs are reused in place
+            BigInt x = {0}, y = {0};
+            bool same = TRUE;
+            for (short op = 0; op < 7; op++) {
+                if (round % 2 == 1) {
+                    BigInt filler = selfTestRandom(6 * n, FALSE, &state);
+                    same = copyBigIntInto(&x, filler) && copyBigIntInto(&y, filler) && same;
+                    freeBigInt(&filler);
+                }
+                same = copyBigIntInto(&x, a) && copyBigIntInto(&y, b) && same;
+                switch (op) {
+                    case 0 : same = addBigIntInto(&x, x, y) && selfTestSame(x, sum) && same; break;
+                    case 1 : same = addBigIntInto(&y, x, y) && selfTestSame(y, sum) && same; break;
+                    case 2 : same = subtractBigIntInto(&x, x, y) && selfTestSame(x, difference) && same; break;
+                    case 3 : same = subtractBigIntInto(&y, x, y) && selfTestSame(y, difference) && same; break;
+                    case 4 : same = multiplyBigIntInto(&y, x, y) && selfTestSame(y, product) && same; break;
+                    case 5 : same = multiplyBigIntInto(&x, x, x) && selfTestSame(x, square) && same; break;
+                    default : same = divmodBigIntInto(&x, &y, x, y) && selfTestSame(x, q) && selfTestSame(y, r) && same; break;
+                }
+            }
+            same = copyBigIntInto(&x, x) && same;
+            if (!same) {
+                fprintf(out, "aliased _into mismatch at %d x %d limbs\n", a.size, b.size);
+                failed++;
+            }
+            freeBigInt(&a);
+            freeBigInt(&b);
+            freeBigInt(&sum);
+            freeBigInt(&difference);
+            freeBigInt(&product);
+            freeBigInt(&square);
+            freeBigInt(&q);
+            freeBigInt(&r);
+            freeBigInt(&x);
+            freeBigInt(&y);
+        }
+    }
+    return failed;
+}
+
+//one check per compile time width: add, sub and compare against the scalar limb kernels, mul against schoolbook limbsMul,
+//isZero, and the trip through bigIntTo / bigIntFrom, which has to refuse a number one limb too wide
+#define DEFINE_SELFTEST_WIDTH(bits, wide) \
+int selfTestWidth##bits (FILE* out, uint64_t* state) { \
+    enum { N = (bits) / LIMB_BITS }; \
+    int failed = 0; \
+    for (short round = 0; round < SELFTEST_ROUNDS; round++) { \
+        BigInt a = selfTestRandom(N, round == 0, state); \
+        BigInt b = selfTestRandom((round % 2 == 1) ? (short)(benchRandomLimb(state) % N) + 1 : N, round == 0, state); \
+        BigInt tooWide = selfTestRandom(N + 1, FALSE, state); \
+        a.sign = POSITIVE; \
+        b.sign = POSITIVE; \
+        BigInt##bits x, y, r, zero; \
+        BigInt##wide product; \
+        limb_t expected[2 * N]; \
+        bool same = (bigIntTo##bits(&x, a) && bigIntTo##bits(&y, b) && !bigIntTo##bits(&r, tooWide)) ? TRUE : FALSE; \
+        memset(&zero, 0, sizeof(zero)); \
+        \
+        limb_t carry = add##bits(&r, &x, &y); \
+        same = (carry == limbsAddNScalar(expected, x.limb_array, y.limb_array, N, 0) && \
+            memcmp(r.limb_array, expected, N * sizeof(limb_t)) == 0) ? same : FALSE; \
+        limb_t borrow = sub##bits(&r, &y, &x); \
+        same = (borrow == limbsSubNScalar(expected, y.limb_array, x.limb_array, N, 0) && \
+            memcmp(r.limb_array, expected, N * sizeof(limb_t)) == 0) ? same : FALSE; \
+        mul##bits(&product, &x, &y); \
+        limbsMul(expected, x.limb_array, N, y.limb_array, N); \
+        same = (memcmp(product.limb_array, expected, 2 * N * sizeof(limb_t)) == 0) ? same : FALSE; \
+        same = (compare##bits(&x, &y) == limbsCompareNScalar(x.limb_array, y.limb_array, N) && \
+            compare##bits(&x, &x) == EQUAL && isZero##bits(&zero) && !isZero##bits(&x)) ? same : FALSE; \
+        \
+        BigInt back = bigIntFrom##bits(&x); \
+        same = selfTestSame(back, a) ? same : FALSE; \
+        if (!same) { \
+            fprintf(out, "BigInt%d mismatch in round %d\n", (bits), round); \
+            failed++; \
+        } \
+        freeBigInt(&a); \
+        freeBigInt(&b); \
+        freeBigInt(&tooWide); \
+        freeBigInt(&back); \
+    } \
+    return failed; \
+}
+
+DEFINE_SELFTEST_WIDTH(512, 1024)
+DEFINE_SELFTEST_WIDTH(1024, 2048)
+DEFINE_SELFTEST_WIDTH(2048, 4096)
+DEFINE_SELFTEST_WIDTH(4096, 8192)
+
+int selfTestWidths (FILE* out) {
+    uint64_t state = 0x5EED000Aull;
+    return selfTestWidth512(out, &state) + selfTestWidth1024(out, &state) + selfTestWidth2048(out, &state) +
+        selfTestWidth4096(out, &state);
+}
+
+//every FixedBigInt operation against the BigInt one, with the result written over the first operand, and
+//fixedReadFromString against readNumFromString
+int selfTestFixed (FILE* out) {
+    uint64_t state = 0x5EED000Bull;
+    int failed = 0;
+    char text[FIXED_LIMBS * 10 + 2];
+    limb_t scratch[MAX_LIMBS + 1];
+
+    for (short round = 0; round < 4 * SELFTEST_ROUNDS; round++) {
+        BigInt a = selfTestRandom((short)(benchRandomLimb(&state) % MAX_LIMBS) + 1, round == 0, &state);
+        BigInt b = selfTestRandom((short)(benchRandomLimb(&state) % MAX_LIMBS) + 1, round == 0, &state);
+        BigInt expected[5];
+        divmodBigInt(a, b, &expected[3], &expected[4]);
+        expected[0] = addTwoNumbers(a, b);
+        expected[1] = subtracTwotBigInts(a, b);
+        expected[2] = multiplyBigInt(a, b);
+        bool same = TRUE;
+
+        for (short op = 0; op < 5; op++) {
+            FixedBigInt x, y, other;
+            fixedFromBigInt(&x, a);
+            fixedFromBigInt(&y, b);
+            switch (op) {
+                case 0 : fixedAdd(&x, &x, &y); break;
+                case 1 : fixedSubtract(&x, &x, &y); break;
+                case 2 : fixedMultiply(&x, &x, &y); break;
+                case 3 : fixedDivide(&x, &x, &y); break;
+                default : fixedDivMod(&other, &x, &x, &y); break;
+            }
+            BigInt result = fixedToBigInt(&x);
+            same = selfTestSame(result, expected[op]) ? same : FALSE;
+            freeBigInt(&result);
+        }
+
+        FixedBigInt parsed;
+        text[0] = (a.sign == NEGATIVE) ? '-' : '+';
+        limbsToDecimal(text + 1, a.limb_array, a.size, scratch);
+        fixedReadFromString(&parsed, text);
+        BigInt back = fixedToBigInt(&parsed);
+        same = selfTestSame(back, a) ? same : FALSE;
+
+        if (!same) {
+            fprintf(out, "fixed mismatch at %d and %d limbs\n", a.size, b.size);
+            failed++;
+        }
+        freeBigInt(&a);
+        freeBigInt(&b);
+        freeBigInt(&back);
+        for (short op = 0; op < 5; op++) {
+            freeBigInt(&expected[op]);
+        }
+    }
+    return failed;
+}
+
+//the dispatched limb kernels selected by selectLimbKernels(TRUE) (AVX2 where the CPU has it) against the scalar ones
+//forced by selectLimbKernels(FALSE), at lengths around the 8 limb vector width, with carries running the whole length
+int selfTestKernels (FILE* out) {
+    short sizes[] = {1, 7, 8, 9, 16, 31, 64, 1000};
+    uint64_t state = 0x5EED000Cull;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short n = sizes[i];
+        for (short round = 0; round < SELFTEST_ROUNDS / 2; round++) {
+            //round 0 is all ones against one, so the carry (and the borrow from the other side) crosses every limb
+            BigInt a = selfTestRandom(n, round == 0, &state);
+            BigInt b = (round == 0) ? selfTestSmall(1) : selfTestRandom(n, FALSE, &state);
+            BigInt c = copyBigInt(a);
+            c.limb_array[benchRandomLimb(&state) % n] ^= (round % 2 == 1) ? 1 : 0; //differs in one limb or not at all
+            BigInt results[2][4];
+            limb_t carries[2][2];
+            short used[2];
+            compareStatus order[2];
+
+            for (short simd = 0; simd < 2; simd++) {
+                selectLimbKernels(simd ? TRUE : FALSE);
+                BigInt wideB = copyBigInt(a);
+                memset(wideB.limb_array, 0, n * sizeof(limb_t));
+                memcpy(wideB.limb_array, b.limb_array, b.size * sizeof(limb_t));
+                results[simd][0] = addTwoNumbers(a, b);
+                results[simd][1] = subtracTwotBigInts(a, b);
+                results[simd][2] = copyBigInt(a);
+                results[simd][3] = copyBigInt(a);
+                carries[simd][0] = limbsAddN(results[simd][2].limb_array, a.limb_array, wideB.limb_array, n, round % 2);
+                carries[simd][1] = limbsSubN(results[simd][3].limb_array, wideB.limb_array, a.limb_array, n, round % 2);
+                order[simd] = limbsCompareN(a.limb_array, c.limb_array, n);
+                memset(wideB.limb_array + n / 2, 0, (n - n / 2) * sizeof(limb_t));
+                used[simd] = limbsUsed(wideB.limb_array, n);
+                freeBigInt(&wideB);
+            }
+
+            bool same = (carries[0][0] == carries[1][0] && carries[0][1] == carries[1][1] && order[0] == order[1] &&
+                used[0] == used[1]) ? TRUE : FALSE;
+            for (short k = 0; k < 4; k++) {
+                same = (results[0][k].size == results[1][k].size && results[0][k].sign == results[1][k].sign &&
+                    memcmp(results[0][k].limb_array, results[1][k].limb_array, results[0][k].size * sizeof(limb_t)) == 0) ? same : FALSE;
+                freeBigInt(&results[0][k]);
+                freeBigInt(&results[1][k]);
+            }
+            if (!same) {
+                fprintf(out, "%s kernels disagree with the scalar ones at %d limbs\n", limbKernelName, n);
+                failed++;
+            }
+            freeBigInt(&a);
+            freeBigInt(&b);
+            freeBigInt(&c);
+        }
+    }
+    selectLimbKernels(TRUE);
+    return failed;
+}
+
+//evaluateJobs on several workers against applyOperation one job at a time, a few long jobs among many short ones make
+//the workers steal, every result still has to land at its own job's index
+int selfTestJobs (FILE* out) {
+    enum { JOBS = 600 };
+    uint64_t state = 0x5EED000Dull;
+    int failed = 0;
+    bigIntJob* jobs = (bigIntJob*) malloc(JOBS * sizeof(bigIntJob));
+    BigInt* results = (BigInt*) malloc(JOBS * sizeof(BigInt));
+    if (jobs == NULL || results == NULL) {
+        printf("memory allocation failed.\n");
         exit(EXIT_FAILURE);
     }
 
-    bool validInput = FALSE;
-    while (!validInput) {
-        scanf("%310s", input_string2);    
-        // Check if input was too long
-        int c;
-        if ((c = getchar()) != '\n' && c != EOF) {
-            // Clear input buffer
-            while ((c = getchar()) != '\n' && c != EOF);
-            printf("Input too long - maximum 309 digits allowed.\n");
-            printf("Please enter a shorter number: ");
+    for (int i = 0; i < JOBS; i++) {
+        short n = (i % 101 == 0) ? 1500 : (short)(benchRandomLimb(&state) % 40) + 1;
+        jobs[i].op = (operation)(benchRandomLimb(&state) % OP_INVALID);
+        jobs[i].a = selfTestRandom(n, i % 50 == 0, &state);
+        jobs[i].b = selfTestRandom((short)(benchRandomLimb(&state) % n) + 1, i % 50 == 0, &state);
+    }
+    for (int threads = 1; threads <= 4; threads += 3) {
+        int failedJobs = 0;
+        limb_t* block = evaluateJobs(jobs, results, JOBS, threads, &failedJobs);
+        if (block == NULL || failedJobs != 0) {
+            fprintf(out, "evaluateJobs failed on %d threads\n", threads);
+            failed++;
+            free(block);
             continue;
         }
+        for (int i = 0; i < JOBS; i++) {
+            BigInt expected = applyOperation(jobs[i].op, jobs[i].a, jobs[i].b);
+            if (!selfTestSame(results[i], expected)) {
+                fprintf(out, "job %d wrong on %d threads\n", i, threads);
+                failed++;
+            }
+            freeBigInt(&expected);
+        }
+        free(block);
+    }
+    for (int i = 0; i < JOBS; i++) {
+        freeBigInt(&jobs[i].a);
+        freeBigInt(&jobs[i].b);
+    }
+    free(jobs);
+    free(results);
+    return failed;
+}
 
-        // Check if input format is valid
-        if (!isValidInput(input_string2)) {
-            printf("Please enter valid input: ");
-            continue;
+//digits of a (n limbs) with the 9 digit loop only, the reference for limbsToDecimal, out needs limbsDecimalLength(n)
+void selfTestDecimalReference (char* out, const limb_t* a, short n) {
+    limb_t* work = (limb_t*) malloc((n > 0 ? n : 1) * sizeof(limb_t));
+    char* digits = (char*) malloc(limbsDecimalLength(n) + DEC_CHUNK_DIGITS);
+    if (work == NULL || digits == NULL) {
+        printf("memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+    char* end = digits + limbsDecimalLength(n) + DEC_CHUNK_DIGITS;
+    char* start = end;
+
+    memcpy(work, a, n * sizeof(limb_t));
+    n = limbsUsed(work, n);
+    while (n > 0) {
+        start = writeChunkDigits(start, limbsDivSmall(work, n, DEC_CHUNK));
+        n = limbsUsed(work, n);
+    }
+    while (start < end && *start == '0') {
+        start += 1;
+    }
+    if (start == end) {
+        *--start = '0';
+    }
+    memcpy(out, start, end - start);
+    out[end - start] = '\0';
+    free(work);
+    free(digits);
+}
+
+//prints x (n random limbs) with limbsToDecimal, compares the digits with the 9 digit loops up to
+//SELFTEST_DECIMAL_REFERENCE limbs, then parses them back with readNumFromString, returns the failures
+int selfTestDecimalRoundTrip (FILE* out, short n, bool allOnes, uint64_t* state) {
+    BigInt x = selfTestRandom(n, allOnes, state);
+    int scratchSize = limbsToDecimalScratch(n);
+    char* text = (char*) malloc(limbsDecimalLength(n) + 1);
+    limb_t* scratch = (limb_t*) malloc((scratchSize > 0 ? scratchSize : 1) * sizeof(limb_t));
+    if (scratchSize < 0 || text == NULL || scratch == NULL) {
+        printf("memory allocation failed.\n");
+        exit(EXIT_FAILURE);
+    }
+    int failed = 0;
+
+    text[0] = (x.sign == NEGATIVE) ? '-' : '+';
+    int length = limbsToDecimal(text + 1, x.limb_array, x.size, scratch);
+    if (n <= SELFTEST_DECIMAL_REFERENCE) {
+        char* expected = (char*) malloc(limbsDecimalLength(n));
+        limb_t* parsed = (limb_t*) malloc(limbsForDecimalDigits(length) * sizeof(limb_t));
+        if (expected == NULL || parsed == NULL) {
+            printf("memory allocation failed.\n");
+            exit(EXIT_FAILURE);
+        }
+        selfTestDecimalReference(expected, x.limb_array, x.size);
+        short parsedSize = limbsFromDecimalChunks(parsed, text + 1, length);
+        if (strcmp(text + 1, expected) != 0 || parsedSize != x.size || memcmp(parsed, x.limb_array, x.size * sizeof(limb_t)) != 0) {
+            fprintf(out, "decimal conversion disagrees with the 9 digit loops at %d limbs\n", n);
+            failed++;
         }
+        free(expected);
+        free(parsed);
+    }
 
-        validInput = TRUE;
+    BigInt back = readNumFromString(text);
+    if (!selfTestSame(back, x)) {
+        fprintf(out, "decimal round trip mismatch at %d limbs (%d digits)\n", n, length);
+        failed++;
     }
+    freeBigInt(&x);
+    freeBigInt(&back);
+    free(text);
+    free(scratch);
+    return failed;
+}
 
-    BigInt b2;
-    printf("second number : ");
-    b2 = readNumFromString(input_string2);
-    printDigits(b2);
-    return b2;
+//decimal conversion at the edges of the 9 digit loops, of the power levels and of the short size, and strings of nines
+//at the digit split boundaries, which have to print back exactly as they were read, DEC_MAX_DIGITS nines do not fit
+int selfTestDecimal (FILE* out) {
+    short sizes[] = {1, 2, DEC_SPLIT_LIMBS, DEC_SPLIT_LIMBS + 1, 149, 150, 151, 1000, 4096, 15308, 15309, 20000, 30617, SHRT_MAX};
+    int digitLengths[] = {DEC_SPLIT_DIGITS, DEC_SPLIT_DIGITS + 1, 2 * DEC_SPLIT_DIGITS + 7, 9 * 512, 9 * 512 + 1, 9 * 4096 + 1};
+    uint64_t state = 0x5EED0006ull;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        short rounds = (sizes[i] > SELFTEST_DECIMAL_REFERENCE) ? 2 : 4; //round 1 is all ones, at SHRT_MAX DEC_MAX_DIGITS long
+        for (short round = 0; round < rounds; round++) {
+            failed += selfTestDecimalRoundTrip(out, sizes[i], round == 1, &state);
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(digitLengths) / sizeof(digitLengths[0]); i++) {
+        int length = digitLengths[i];
+        char* text = (char*) malloc(length + 2);
+        char* back = (char*) malloc(limbsDecimalLength(limbsForDecimalDigits(length)));
+        if (text == NULL || back == NULL) {
+            printf("memory allocation failed.\n");
+            exit(EXIT_FAILURE);
+        }
+        text[0] = '+';
+        memset(text + 1, '9', length);
+        text[length + 1] = '\0';
+        BigInt x = readNumFromString(text);
+        limb_t* scratch = (limb_t*) malloc((limbsToDecimalScratch(x.size) + 1) * sizeof(limb_t));
+        if (scratch == NULL) {
+            printf("memory allocation failed.\n");
+            exit(EXIT_FAILURE);
+        }
+        limbsToDecimal(back, x.limb_array, x.size, scratch);
+        if (strcmp(back, text + 1) != 0) {
+            fprintf(out, "%d nines do not print back\n", length);
+            failed++;
+        }
+        freeBigInt(&x);
+        free(text);
+        free(back);
+        free(scratch);
+    }
+
+    for (int extra = 0; extra < 2; extra++) {
+        char* text = (char*) malloc(DEC_MAX_DIGITS + extra + 2);
+        if (text == NULL) {
+            printf("memory allocation failed.\n");
+            exit(EXIT_FAILURE);
+        }
+        text[0] = '+';
+        memset(text + 1, '9', DEC_MAX_DIGITS + extra);
+        text[DEC_MAX_DIGITS + extra + 1] = '\0';
+        clearBigIntStatus();
+        BigInt x = readNumFromString(text);
+        if (x.size != 0 || (getBigIntStatus() & BIGINT_OVERFLOW) == 0) {
+            fprintf(out, "%d nines were not refused\n", DEC_MAX_DIGITS + extra);
+            failed++;
+        }
+        freeBigInt(&x);
+        free(text);
+    }
+    return failed;
 }
 
-int main() {
+//runs every check, returns FALSE when any of them failed
+bool runSelfTest (FILE* out) {
+    int failed = 0;
+    failed += selfTestReport(out, "kernels", selfTestKernels(out));
+    failed += selfTestReport(out, "multiply", selfTestMultiply(out));
+    failed += selfTestReport(out, "divide", selfTestDivide(out));
+    failed += selfTestReport(out, "barrett", selfTestBarrett(out));
+    failed += selfTestReport(out, "modpow", selfTestModPowTiers(out));
+    failed += selfTestReport(out, "gcd", selfTestGcd(out));
+    failed += selfTestReport(out, "primes", selfTestPrimes(out));
+    failed += selfTestReport(out, "addmul", selfTestAddMul(out));
+    failed += selfTestReport(out, "into", selfTestInto(out));
+    failed += selfTestReport(out, "accumulator", selfTestAccumulator(out));
+    failed += selfTestReport(out, "widths", selfTestWidths(out));
+    failed += selfTestReport(out, "fixed", selfTestFixed(out));
+    failed += selfTestReport(out, "jobs", selfTestJobs(out));
+    failed += selfTestReport(out, "decimal", selfTestDecimal(out));
+    freeWorkspace();
+    freeBarrettCache();
+    clearBigIntStatus(); //wide results raise BIGINT_OVERFLOW along the way, that is expected here
+
+    fprintf(out, (failed == 0) ? "every check passed\n" : "%d checks failed\n", failed);
+    return failed == 0;
+}
+
+int main(int argc, char* argv[]) {
+    //--stats anywhere on the command line dumps the counters as json to stderr when the program exits
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stats") == 0) {
+#ifdef BIGINT_STATS
+            atexit(dumpBigIntStatsAtExit);
+#else
+            fprintf(stderr, "--stats needs a build with -DBIGINT_STATS\n");
+#endif
+            memmove(&argv[i], &argv[i + 1], (argc - i) * sizeof(char*)); //argv[argc] is NULL and moves down too
+            argc -= 1;
+            i -= 1;
+        }
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) {
+        runBenchmarks(stdout);
+        return EXIT_SUCCESS;
+    }
+    if (argc >= 2 && strcmp(argv[1], "--selftest") == 0) {
+        return runSelfTest(stdout) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (argc >= 2 && strcmp(argv[1], "--tune") == 0) {
+        return tuneThresholds(stdout, (argc >= 3) ? argv[2] : "bigint_tuned.h") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (argc >= 2 && strcmp(argv[1], "--batch") == 0) {
+        FILE* in = stdin;
+        int threads = 1;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                threads = atoi(argv[++i]);
+            } else if (in == stdin) {
+                in = fopen(argv[i], "r");
+                if (in == NULL) {
+                    fprintf(stderr, "cannot open %s\n", argv[i]);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        setvbuf(stdout, NULL, _IOFBF, BATCH_OUTPUT_BUFFER);
+        int failed = runBatch(in, stdout, threads);
+        if (in != stdin) {
+            fclose(in);
+        }
+        return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--pack") == 0) {
+        //--pack [in.txt] out.bin [--limbs n]
+        const char* paths[2] = {NULL, NULL};
+        int pathCount = 0;
+        long width = MAX_LIMBS; //long until it is checked, a record width has to fit a short
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--limbs") == 0 && i + 1 < argc) {
+                char* end;
+                width = strtol(argv[++i], &end, 10);
+                if (*end != '\0') {
+                    width = 0;
+                }
+            } else if (pathCount < 2) {
+                paths[pathCount++] = argv[i];
+            }
+        }
+        if (pathCount == 0 || width <= 0 || width > SHRT_MAX) {
+            fprintf(stderr, "usage: bigint --pack [in.txt] out.bin [--limbs n], 1 <= n <= %d\n", SHRT_MAX);
+            return EXIT_FAILURE;
+        }
+        FILE* in = stdin;
+        if (pathCount == 2) {
+            in = fopen(paths[0], "r");
+            if (in == NULL) {
+                fprintf(stderr, "cannot open %s\n", paths[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        long failed = packDecimalFile(in, paths[pathCount - 1], (short)width);
+        if (in != stdin) {
+            fclose(in);
+        }
+        return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (argc >= 3 && strcmp(argv[1], "--unpack") == 0) {
+        setvbuf(stdout, NULL, _IOFBF, BATCH_OUTPUT_BUFFER);
+        return unpackBigIntFile(stdout, argv[2]) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (argc >= 2 && strcmp(argv[1], "--map") == 0) {
+        //--map op a.bin b.bin out.bin
+        operation op = (argc == 6) ? parseOperation(argv[2]) : OP_INVALID;
+        if (op == OP_INVALID) {
+            fprintf(stderr, "usage: bigint --map op a.bin b.bin out.bin\n");
+            return EXIT_FAILURE;
+        }
+        return (runMappedOperation(op, argv[3], argv[4], argv[5]) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     BigInt b1;
     BigInt b2;
     system("cls"); //clears terminal every times it runs
@@ -693,6 +6845,7 @@ int main() {
                 printf("sum of two numbers is : ");
                 printDigits(b);
                 freeBigInt(&b); 
+                reportBigIntStatus();
                 break;
             }
 
@@ -705,6 +6858,7 @@ int main() {
                 printf("difference of two numbers is : ");
                 printDigits(b);
                 freeBigInt(&b);
+                reportBigIntStatus();
                 break;
             }
 
@@ -716,6 +6870,7 @@ int main() {
                 BigInt b_karatsuba = karatsubaMultiply(b1, b2);
                 printf("product of two numbers is : ");
                 printDigits(b_karatsuba);
+                reportBigIntStatus();
                 freeBigInt(&b_karatsuba);
                 break;
             }
@@ -727,6 +6882,7 @@ int main() {
                 b = divideBigInt(b1, b2);
                 printf("division of two numbers is : ");
                 printDigits(b);
+                reportBigIntStatus();
                 break;
             }
 
@@ -759,4 +6915,4 @@ int main() {
     freeBigInt(&b2);
 
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file